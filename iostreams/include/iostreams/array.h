@@ -13,6 +13,8 @@
 #define _IOSTREAMS_ARRAY_H_
 
 #include "iostreams/stream.h"
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace iostreams
@@ -24,6 +26,8 @@ namespace iostreams
 		using size_type = typename IStream<byte_type>::size_type;
 		using count_type = typename IStream<byte_type>::count_type;
 		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
 
 	private:
 		std::vector<byte_type> data_;
@@ -53,6 +57,54 @@ namespace iostreams
 		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
 		count_type write(const byte_type* data, count_type size) override;
 		count_type read(byte_type* buffer, count_type count) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+		count_type readv(const Buffer* buffers, count_type count) override;
+		count_type writev(const ConstBuffer* buffers, count_type count) override;
+	};
+
+	// read-only stream over memory it does not copy, copies share the memory
+	template<typename byte_type>
+	class ConstArrayStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+		using deleter_type = std::function<void(const byte_type*)>;
+
+	private:
+		std::shared_ptr<const byte_type> data_;
+		size_type size_{ 0 };
+		size_type position_{ 0 };
+
+	public:
+		ConstArrayStream() {}
+
+		// the memory stays owned by the caller and must outlive the stream
+		ConstArrayStream(const byte_type* data, size_type size);
+
+		// the deleter is called once the last copy of the stream is destroyed
+		ConstArrayStream(const byte_type* data, size_type size, deleter_type deleter);
+		ConstArrayStream(const std::shared_ptr<const byte_type>& data, size_type size);
+		explicit ConstArrayStream(std::vector<byte_type>&& data);
+
+		const byte_type* data() const { return data_.get(); }
+
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+
+		size_type size() const override { return size_; }
+		size_type tell() const override { return position_; }
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+		void resize(size_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+		count_type readv(const Buffer* buffers, count_type count) override;
+		count_type writev(const ConstBuffer* buffers, count_type count) override;
 	};
 }
 
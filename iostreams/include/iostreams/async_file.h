@@ -0,0 +1,129 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_ASYNC_FILE_H_
+#define _IOSTREAMS_ASYNC_FILE_H_
+
+#ifdef __linux__
+#include "iostreams/file.h"
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace iostreams
+{
+	enum class AsyncEngine : uint8_t
+	{
+		AUTO = 0,
+		IO_URING,
+		THREAD_POOL
+	};
+
+	// Submission/completion queue shared by any number of AsyncFileStream objects. Operations are batched
+	// until submit(); completions run on the io_uring completion thread or on the pool workers, so
+	// callbacks must not block; they may queue and submit more I/O. Both engines finish short transfers
+	// before completing. AUTO falls back to the thread pool when io_uring is unavailable.
+	class AsyncIOService
+	{
+	public:
+		using size_type = uint64_t;
+		using count_type = size_t;
+		using callback_type = std::function<void(count_type, std::exception_ptr)>;
+
+		static constexpr unsigned DEFAULT_QUEUE_DEPTH{ 256 };
+		static constexpr unsigned DEFAULT_THREAD_COUNT{ 4 };
+
+	private:
+		struct Operation;
+		class Impl;
+		class IoUringImpl;
+		class ThreadPoolImpl;
+
+		std::unique_ptr<Impl> pimpl_;
+		AsyncEngine engine_;
+
+	public:
+		explicit AsyncIOService(AsyncEngine engine = AsyncEngine::AUTO, unsigned queue_depth = DEFAULT_QUEUE_DEPTH, unsigned thread_count = DEFAULT_THREAD_COUNT);
+
+		AsyncIOService(const AsyncIOService&) = delete;
+		AsyncIOService& operator=(const AsyncIOService&) = delete;
+
+		// submits the queued operations and waits for all of them to complete
+		~AsyncIOService();
+
+		// IO_URING or THREAD_POOL, never AUTO
+		AsyncEngine engine() const { return engine_; }
+
+		// the buffer must stay valid until the callback is invoked
+		void read(int fd, size_type offset, void* buffer, count_type count, callback_type callback);
+		void write(int fd, size_type offset, const void* data, count_type count, callback_type callback);
+		void submit();
+	};
+
+	// FileStream with positional asynchronous reads and writes on top of AsyncIOService. The synchronous
+	// IStream interface stays available and shares the descriptor; close waits for in-flight operations.
+	template<typename byte_type>
+	class AsyncFileStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using callback_type = AsyncIOService::callback_type;
+
+	private:
+		struct PendingOperations;
+
+		FileStream<byte_type> file_;
+		std::shared_ptr<AsyncIOService> service_;
+		std::shared_ptr<PendingOperations> pending_;
+		bool is_close_{ false };
+
+	public:
+		AsyncFileStream(AsyncFileStream&& stream);
+		AsyncFileStream& operator=(AsyncFileStream&& stream);
+
+		AsyncFileStream(const AsyncFileStream&) = delete;
+		AsyncFileStream& operator=(const AsyncFileStream&) = delete;
+
+		~AsyncFileStream();
+
+		static AsyncFileStream open(const std::shared_ptr<AsyncIOService>& service, const char* path, FileAccess file_access, FileMode file_mode, FileShare file_share, uint64_t flags = 0);
+
+		const std::string& path() const { return file_.path(); }
+		FileAccess file_access() const { return file_.file_access(); }
+		const std::shared_ptr<AsyncIOService>& service() const { return service_; }
+
+		std::future<count_type> async_read(size_type offset, byte_type* buffer, count_type count);
+		std::future<count_type> async_write(size_type offset, const byte_type* data, count_type count);
+		void async_read(size_type offset, byte_type* buffer, count_type count, callback_type callback);
+		void async_write(size_type offset, const byte_type* data, count_type count, callback_type callback);
+
+		void submit() { service_->submit(); }
+		void close();
+
+		size_type size() const override;
+		size_type tell() const override;
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+		void resize(size_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+
+	private:
+		AsyncFileStream(FileStream<byte_type>&& file, const std::shared_ptr<AsyncIOService>& service);
+	};
+}
+#endif
+#endif
\ No newline at end of file
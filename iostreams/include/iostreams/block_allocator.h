@@ -0,0 +1,115 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_BLOCK_ALLOCATOR_H_
+#define _IOSTREAMS_BLOCK_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace iostreams
+{
+	// Source of MemoryStream blocks. Blocks are not zero-initialized; dropping the last reference
+	// hands the block back to the allocator that produced it.
+	template<typename byte_type>
+	struct IBlockAllocator
+	{
+		static_assert(std::is_same<char, byte_type>::value || std::is_same<uint8_t, byte_type>::value, "byte_type must be char or uint8_t");
+
+		virtual ~IBlockAllocator() {}
+		virtual std::shared_ptr<byte_type> allocate(size_t block_size) = 0;
+	};
+
+	template<typename byte_type>
+	class HeapBlockAllocator : public IBlockAllocator<byte_type>
+	{
+	public:
+		static const std::shared_ptr<HeapBlockAllocator>& instance();
+
+		std::shared_ptr<byte_type> allocate(size_t block_size) override;
+	};
+
+#ifdef __linux__
+	enum class HugePageMode : uint8_t
+	{
+		TRANSPARENT = 0,
+		EXPLICIT
+	};
+
+	// Blocks mapped with mmap and backed by 2 MiB pages: TRANSPARENT asks khugepaged through
+	// madvise(MADV_HUGEPAGE), EXPLICIT uses MAP_HUGETLB and falls back to TRANSPARENT when no huge pages
+	// are reserved. Block sizes are rounded up to HUGE_PAGE_SIZE, so MemoryStream block sizes should be
+	// multiples of it. A non-negative numa_node binds the blocks to that node.
+	template<typename byte_type>
+	class HugePageBlockAllocator : public IBlockAllocator<byte_type>
+	{
+	private:
+		HugePageMode mode_;
+		int numa_node_;
+
+	public:
+		static constexpr size_t HUGE_PAGE_SIZE{ 2 * 1024 * 1024 };
+
+		explicit HugePageBlockAllocator(HugePageMode mode = HugePageMode::TRANSPARENT, int numa_node = -1)
+			: mode_(mode), numa_node_(numa_node)
+		{}
+
+		HugePageMode mode() const { return mode_; }
+		int numa_node() const { return numa_node_; }
+
+		std::shared_ptr<byte_type> allocate(size_t block_size) override;
+	};
+#endif
+
+	// Thread-safe pool of equally sized blocks that may be shared by any number of streams. Released blocks
+	// are kept for reuse up to max_free_blocks; requests for another size are served from the heap.
+	template<typename byte_type>
+	class BlockPool : public IBlockAllocator<byte_type>, public std::enable_shared_from_this<BlockPool<byte_type>>
+	{
+	private:
+		size_t block_size_;
+		size_t max_free_blocks_;
+		mutable std::mutex mutex_;
+		std::vector<byte_type*> free_blocks_;
+		std::atomic<size_t> used_blocks_{ 0 };
+
+		BlockPool(size_t block_size, size_t max_free_blocks);
+
+	public:
+		static constexpr size_t DEFAULT_MAX_FREE_BLOCKS{ 64 };
+
+		static std::shared_ptr<BlockPool> create(size_t block_size, size_t max_free_blocks = BlockPool::DEFAULT_MAX_FREE_BLOCKS);
+
+		BlockPool(const BlockPool&) = delete;
+		BlockPool& operator=(const BlockPool&) = delete;
+
+		~BlockPool();
+
+		size_t block_size() const { return block_size_; }
+		size_t max_free_blocks() const { return max_free_blocks_; }
+		size_t used_blocks() const { return used_blocks_; }
+		size_t free_blocks() const;
+
+		std::shared_ptr<byte_type> allocate(size_t block_size) override;
+
+		// returns the cached free blocks to the heap
+		void trim();
+
+	private:
+		static void release(const std::weak_ptr<BlockPool>& pool, byte_type* block);
+	};
+}
+
+#endif
\ No newline at end of file
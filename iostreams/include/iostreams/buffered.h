@@ -0,0 +1,81 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_BUFFERED_H_
+#define _IOSTREAMS_BUFFERED_H_
+
+#include "iostreams/stream.h"
+#include <memory>
+#include <vector>
+
+namespace iostreams
+{
+	// Decorator that serves small reads from a read-ahead window and coalesces small writes into a
+	// write-behind buffer. The wrapped stream is accessed with pread/pwrite only, so seek never does I/O;
+	// pending writes are flushed before reads, on a non-contiguous write, resize, flush and destruction.
+	template<typename byte_type>
+	class BufferedStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using stream_type = IStream<byte_type>;
+
+	private:
+		std::shared_ptr<stream_type> stream_;
+		size_type position_{ 0 };
+
+		std::vector<byte_type> read_buffer_;
+		size_type read_begin_{ 0 };
+		count_type read_size_{ 0 };
+
+		std::vector<byte_type> write_buffer_;
+		size_type write_begin_{ 0 };
+		count_type write_size_{ 0 };
+
+	public:
+		static constexpr count_type DEFAULT_BUFFER_SIZE{ 64 * 1024 };
+
+		explicit BufferedStream(const std::shared_ptr<stream_type>& stream)
+			: BufferedStream(stream, BufferedStream::DEFAULT_BUFFER_SIZE, BufferedStream::DEFAULT_BUFFER_SIZE)
+		{}
+
+		// a zero size disables the corresponding buffer
+		BufferedStream(const std::shared_ptr<stream_type>& stream, count_type read_buffer_size, count_type write_buffer_size);
+
+		BufferedStream(BufferedStream&& stream);
+		BufferedStream& operator=(BufferedStream&& stream);
+
+		BufferedStream(const BufferedStream&) = delete;
+		BufferedStream& operator=(const BufferedStream&) = delete;
+
+		~BufferedStream();
+
+		const std::shared_ptr<stream_type>& stream() const { return stream_; }
+		count_type read_buffer_size() const { return read_buffer_.size(); }
+		count_type write_buffer_size() const { return write_buffer_.size(); }
+
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		size_type size() const override;
+		size_type tell() const override { return position_; }
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+		void resize(size_type size) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+
+		void flush();
+	};
+}
+
+#endif
\ No newline at end of file
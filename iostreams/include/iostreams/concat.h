@@ -0,0 +1,62 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_CONCAT_H_
+#define _IOSTREAMS_CONCAT_H_
+
+#include "iostreams/stream.h"
+#include <memory>
+#include <vector>
+
+namespace iostreams
+{
+	// Read-only view of several streams joined in order. Part boundaries are kept in a prefix-size index,
+	// so locating an offset is a binary search; a read spans as many parts as needed. The parts are only
+	// accessed through pread, their positions are never moved. Call refresh after a part changed its size.
+	template<typename byte_type>
+	class ConcatStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+		using stream_type = IStream<byte_type>;
+
+	private:
+		std::vector<std::shared_ptr<stream_type>> streams_;
+		// offsets_[i] is the offset of the first byte of streams_[i], the last element is the total size
+		std::vector<size_type> offsets_{ 0 };
+		size_type position_{ 0 };
+
+	public:
+		ConcatStream() {}
+		explicit ConcatStream(std::vector<std::shared_ptr<stream_type>> streams);
+
+		const std::vector<std::shared_ptr<stream_type>>& streams() const { return streams_; }
+
+		void append(const std::shared_ptr<stream_type>& stream);
+		void refresh();
+
+		size_type size() const override { return offsets_.back(); }
+		size_type tell() const override { return position_; }
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+		void resize(size_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+	};
+}
+
+#endif
\ No newline at end of file
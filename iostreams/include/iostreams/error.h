@@ -31,6 +31,14 @@ namespace iostreams
 		DECLARE_ERROR_INFO(BAD_BASE64_STRING_LENGTH, 11, "invalid base64 string length");
 		DECLARE_ERROR_INFO(BAD_HEX_CHARACTER, 12, "invalid hex string character");
 		DECLARE_ERROR_INFO(BAD_HEX_STRING_LENGTH, 13, "invalid hex string length");
+		DECLARE_ERROR_INFO(STREAM_READ_ONLY, 14, "the stream does not support writing");
+		DECLARE_ERROR_INFO(INCOMPLETE_WRITE, 15, "the stream accepted fewer bytes than requested");
+		DECLARE_ERROR_INFO(NOT_SUPPORTED, 16, "the operation is not supported on this platform");
+		DECLARE_ERROR_INFO(STREAM_WRITE_ONLY, 17, "the stream does not support reading");
+		DECLARE_ERROR_INFO(STREAM_NOT_SEEKABLE, 18, "the stream does not support positioning");
+		DECLARE_ERROR_INFO(BROKEN_PIPE, 19, "the read end of the pipe has been closed");
+		DECLARE_ERROR_INFO(BAD_BASE64_LINE_LENGTH, 20, "base64 line length must be a multiple of 4");
+		DECLARE_ERROR_INFO(DIRECT_IO_REQUIRES_CACHE, 21, "position and size must stay cached while direct I/O is on");
 	}
 
 	class IOStreamsException : public liberror::Exception
@@ -13,6 +13,7 @@
 #define _IOSTREAMS_FILE_H_
 
 #include "iostreams/stream.h"
+#include <chrono>
 #include <string>
 #include <memory>
 #include <sys/stat.h>
@@ -66,6 +67,24 @@ namespace iostreams
 #endif
 	};
 
+	enum class FileAccessPattern : uint8_t
+	{
+		NORMAL = 0,
+		SEQUENTIAL,
+		RANDOM,
+		WILL_NEED,
+		DONT_NEED
+	};
+
+	// Group commit: instead of an fsync per write, data is synced once bytes_threshold bytes were written
+	// or once per interval, optionally from a background thread. Zero values disable the trigger.
+	struct FlushPolicy
+	{
+		uint64_t bytes_threshold{ 0 };
+		std::chrono::milliseconds interval{ 0 };
+		bool background{ false };
+	};
+
     template<typename byte_type>
     class FileStream : public IStream<byte_type>
     {
@@ -83,6 +102,13 @@ namespace iostreams
         using size_type = typename IStream<byte_type>::size_type;
 		using count_type = typename IStream<byte_type>::count_type;
         using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+#ifdef _WIN32
+		using native_handle_type = HANDLE;
+#elif defined (__linux__) || defined (__APPLE__)
+		using native_handle_type = int;
+#endif
 
 		FileStream(FileStream&& stream);
 		FileStream& operator=(FileStream&& stream);
@@ -95,15 +121,49 @@ namespace iostreams
 		static FileStream create(FILE* file);
 		static FileStream open(const char* path, FileAccess file_access, FileMode file_mode, FileShare file_share, uint64_t flags = 0);
 
+		// anonymous read-write file that is removed once closed; created in the system temporary directory
+		// when directory is null (O_TMPFILE where supported, mkstemp and unlink otherwise)
+		static FileStream temporary(const char* directory = nullptr);
+
 		const std::string& path() const { return path_; }
 
 		FileAccess file_access() const { return file_access_; }
 		FileMode file_mode() const { return file_mode_; }
 		FileShare file_share() const { return file_share_; }
 
+		native_handle_type native_handle() const;
+
 		bool auto_flush() const;
 		void set_auto_flush(bool val);
 
+		// auto_flush takes precedence over the flush policy
+		FlushPolicy flush_policy() const;
+		void set_flush_policy(const FlushPolicy& policy);
+
+		// flush makes written data durable (fdatasync), sync also persists the metadata (fsync)
+		void flush();
+		void sync();
+
+		// keeps position and size in user space so tell, size and seek do not touch the kernel;
+		// call refresh after the file was changed through another handle
+		bool cache_state() const;
+		void set_cache_state(bool val);
+		void refresh();
+
+		// O_DIRECT (F_NOCACHE on macOS) bypasses the page cache: unaligned requests go through an aligned
+		// bounce buffer with read-modify-write of partial blocks, position and size are cached and the file
+		// is truncated back to its logical size on close. Opening with O_DIRECT in flags enables it as well;
+		// while it is on set_cache_state(false) throws DIRECT_IO_REQUIRES_CACHE and refresh only picks up a
+		// file that shrank, growth through another handle is indistinguishable from the block padding.
+		bool direct_io() const;
+		void set_direct_io(bool val);
+
+		// access hint for [offset, offset + length), a zero length extends to the end of the file
+		void advise(FileAccessPattern pattern, size_type offset = 0, size_type length = 0);
+
+		// allocates disk space up to size without changing the file size
+		void reserve(size_type size);
+
 		void close();
 
         size_type size() const override;
@@ -113,12 +173,16 @@ namespace iostreams
         void resize(size_type size) override;
 		count_type read(byte_type* buffer, count_type count) override;
 		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+		count_type readv(const Buffer* buffers, count_type count) override;
+		count_type writev(const ConstBuffer* buffers, count_type count) override;
 
 	protected:
 		FileStream(std::unique_ptr<FileImpl> pimpl, const char* path, FileAccess file_access, FileMode file_mode, FileShare file_share);
 		FileStream(std::unique_ptr<FileImpl> pimpl);
 
-		static void check_seek_range(off_type off, std::ios_base::seekdir way, size_type current_position, size_type size);
+		static size_type check_seek_range(off_type off, std::ios_base::seekdir way, size_type current_position, size_type size);
     };
 }
 #endif
\ No newline at end of file
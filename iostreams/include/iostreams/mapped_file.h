@@ -0,0 +1,83 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_MAPPED_FILE_H_
+#define _IOSTREAMS_MAPPED_FILE_H_
+
+#if defined (__linux__) || defined (__APPLE__)
+#include "iostreams/file.h"
+
+namespace iostreams
+{
+	// File stream served from a shared memory mapping: read, seek and tell never enter the kernel.
+	// Writable mappings grow geometrically, the file is truncated to the logical size on flush and close.
+	// Between them the file on disk is padded with zeros up to capacity(), which is also what a concurrent
+	// reader or the file left by a crash sees.
+	template<typename byte_type>
+	class MappedFileStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+
+	private:
+		FileStream<byte_type> file_;
+		byte_type* data_{ nullptr };
+		size_type size_{ 0 };
+		size_type capacity_{ 0 };
+		size_type position_{ 0 };
+		bool writable_{ false };
+		bool is_close_{ false };
+
+	public:
+		MappedFileStream(MappedFileStream&& stream);
+		MappedFileStream& operator=(MappedFileStream&& stream);
+
+		MappedFileStream(const MappedFileStream&) = delete;
+		MappedFileStream& operator=(const MappedFileStream&) = delete;
+
+		~MappedFileStream();
+
+		// FileAccess::WRITE is opened as READ_WRITE because shared mappings require a readable descriptor
+		static MappedFileStream open(const char* path, FileAccess file_access, FileMode file_mode, FileShare file_share, uint64_t flags = 0);
+
+		const std::string& path() const { return file_.path(); }
+		FileAccess file_access() const { return file_.file_access(); }
+		size_type capacity() const { return capacity_; }
+
+		// zero-copy access to [offset, offset + count), valid until the next write, resize or close
+		const byte_type* view(size_type offset, count_type count) const;
+
+		void flush();
+		void close();
+
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		size_type size() const override;
+		size_type tell() const override;
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+		void resize(size_type new_size) override;
+		void reserve(size_type count);
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type count) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type count) override;
+
+	private:
+		MappedFileStream(FileStream<byte_type>&& file, bool writable);
+
+		void unmap();
+		void remap(size_type new_capacity);
+	};
+}
+
+#endif
+#endif
\ No newline at end of file
@@ -13,6 +13,9 @@
 #define _IOSTREAMS_MEMORY_H_
 
 #include "iostreams/stream.h"
+#include "iostreams/block_allocator.h"
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace iostreams
@@ -24,6 +27,9 @@ namespace iostreams
 		using size_type = typename IStream<byte_type>::size_type;
 		using count_type = typename IStream<byte_type>::count_type;
 		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+		using allocator_type = IBlockAllocator<byte_type>;
 
 	private:
 		count_type block_size_;
@@ -32,23 +38,35 @@ namespace iostreams
 		count_type relative_position_{ 0 };
 		size_type size_{ 0 };
 		size_type capacity_{ 0 };
-		std::vector<std::vector<byte_type>> blocks_;
+		std::vector<std::shared_ptr<byte_type>> blocks_;
+		std::shared_ptr<allocator_type> allocator_;
 
 	public:
 		static constexpr count_type DEFAULT_BLOCK_SIZE{ 1024 * 1024 };
 
 		MemoryStream()
-			: block_size_(MemoryStream::DEFAULT_BLOCK_SIZE)
+			: MemoryStream(MemoryStream::DEFAULT_BLOCK_SIZE)
 		{}
 
 		explicit MemoryStream(count_type block_size)
+			: MemoryStream(block_size, HeapBlockAllocator<byte_type>::instance())
+		{}
+
+		MemoryStream(count_type block_size, const std::shared_ptr<allocator_type>& allocator)
 			: block_size_(block_size != 0 ? block_size : MemoryStream::DEFAULT_BLOCK_SIZE)
+			, allocator_(allocator)
 		{}
 
+		// adopts the vector as the only block without copying it
 		explicit MemoryStream(std::vector<byte_type>&& block)
 			: block_size_(!block.empty() ? block.size() : MemoryStream::DEFAULT_BLOCK_SIZE), size_(block.size()), capacity_(block.size())
+			, allocator_(HeapBlockAllocator<byte_type>::instance())
 		{
-			blocks_.push_back(std::forward<std::vector<byte_type>>(block));
+			if (!block.empty())
+			{
+				auto holder = std::make_shared<std::vector<byte_type>>(std::move(block));
+				blocks_.push_back(std::shared_ptr<byte_type>(holder, holder->data()));
+			}
 		}
 
 		MemoryStream(MemoryStream&& stream)
@@ -58,6 +76,7 @@ namespace iostreams
 			, size_(stream.size_)
 			, capacity_(stream.capacity_)
 			, blocks_(std::move(stream.blocks_))
+			, allocator_(stream.allocator_)
 		{
 			stream.block_index_ = 0;
 			stream.relative_position_ = 0;
@@ -73,6 +92,7 @@ namespace iostreams
 			size_ = stream.size_;
 			capacity_ = stream.capacity_;
 			blocks_ = std::move(stream.blocks_);
+			allocator_ = stream.allocator_;
 
 			stream.block_index_ = 0;
 			stream.relative_position_ = 0;
@@ -82,14 +102,23 @@ namespace iostreams
 			return *this;
 		}
 
-		MemoryStream(const MemoryStream&) = default;
-		MemoryStream& operator=(const MemoryStream&) = default;
+		// copies share the blocks, a block is duplicated on the first write while it is still shared
+		MemoryStream(const MemoryStream& stream) = default;
+		MemoryStream& operator=(const MemoryStream& stream) = default;
 
 		~MemoryStream() {}
 
 		static MemoryStream create(const std::string& str, IFromStringTransform<byte_type>& transformer);
 
+		// adopts the memory as the only block without copying it, the deleter is called once no stream references it,
+		// without a deleter the memory stays owned by the caller and must outlive the stream and its copies
+		static MemoryStream adopt(byte_type* data, size_type size, std::function<void(byte_type*)> deleter = nullptr);
+
+		// copy-on-write copy positioned at the beginning, O(number of blocks)
+		MemoryStream snapshot() const;
+
 		size_type capacity() const { return capacity_;  }
+		const std::shared_ptr<allocator_type>& allocator() const { return allocator_; }
 		count_type block_size() const { return block_size_; }
 		size_type size() const override { return size_; }
 
@@ -105,11 +134,41 @@ namespace iostreams
 		count_type read(byte_type* buffer, count_type count) override;
 		count_type write(const byte_type* data, count_type count) override;
 
+		// concurrent preads are safe; pwrite is safe for disjoint ranges that do not grow the stream
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type count) override;
+		count_type readv(const Buffer* buffers, count_type count) override;
+		count_type writev(const ConstBuffer* buffers, count_type count) override;
+
+		// writes the whole content or [offset, offset + count) to the stream with a single writev over the blocks
+		size_type write_to(IStream<byte_type>* stream) const;
+		size_type write_to(IStream<byte_type>* stream, size_type offset, size_type count) const;
+
+		// reads up to count bytes from the stream straight into the blocks at the current position
+		size_type read_from(IStream<byte_type>* stream, size_type count);
+
+		// spans of the content or of [offset, offset + count), valid until the next non-const call
+		std::vector<ConstBuffer> blocks() const { return blocks(0, size_); }
+		std::vector<ConstBuffer> blocks(size_type offset, size_type count) const;
+
+		// writable spans of count bytes past the end, commit appends the first count bytes of them
+		std::vector<Buffer> prepare(size_type count);
+		void commit(size_type count);
+
 	private:
 		inline size_type current_position() const
 		{
 			return static_cast<size_type>(block_index_ * block_size_ + relative_position_);
 		}
+
+		inline void set_position(size_type position)
+		{
+			block_index_ = static_cast<count_type>(position / block_size_);
+			relative_position_ = static_cast<count_type>(position % block_size_);
+		}
+
+		byte_type* writable_block(count_type index);
+		std::vector<Buffer> writable_blocks(size_type offset, size_type count);
 	};
 }
 
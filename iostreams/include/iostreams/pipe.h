@@ -0,0 +1,90 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_PIPE_H_
+#define _IOSTREAMS_PIPE_H_
+
+#include "iostreams/stream.h"
+#include <memory>
+#include <utility>
+
+namespace iostreams
+{
+	// One end of a single-producer/single-consumer pipe. The ends share a lock-free ring buffer, the mutex is
+	// only taken to sleep when the ring is full (writer) or empty (reader) in blocking mode. Each end must be
+	// used by one thread at a time. size() is the number of bytes that went into the pipe as seen by this end,
+	// tell() the number of bytes this end has written or read; seeking and resizing are not supported.
+	template<typename byte_type>
+	class PipeStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+
+	private:
+		struct State;
+
+		std::shared_ptr<State> state_;
+		bool writer_{ false };
+		bool blocking_{ true };
+
+	public:
+		static constexpr count_type DEFAULT_CAPACITY{ 1024 * 1024 };
+
+		// returns the write end and the read end; the capacity is rounded up to a power of two
+		static std::pair<PipeStream, PipeStream> create(count_type capacity = PipeStream::DEFAULT_CAPACITY);
+
+		PipeStream(PipeStream&& stream);
+		PipeStream& operator=(PipeStream&& stream);
+
+		PipeStream(const PipeStream&) = delete;
+		PipeStream& operator=(const PipeStream&) = delete;
+
+		~PipeStream();
+
+		bool is_writer() const { return writer_; }
+		count_type capacity() const;
+
+		// a blocking writer waits for free space and writes everything, a blocking reader waits for at least
+		// one byte; in non-blocking mode both transfer what fits right now and may return 0
+		bool blocking() const { return blocking_; }
+		void set_blocking(bool val) { blocking_ = val; }
+
+		// bytes ready to be read (read end) or free space (write end)
+		count_type available() const;
+
+		// the write end has been closed and everything has been read
+		bool eof() const;
+
+		// closing the write end signals the end of data, closing the read end makes further writes throw BROKEN_PIPE
+		void close();
+
+		size_type size() const override;
+		size_type tell() const override;
+
+		// drains the read end until the end of data
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+		void resize(size_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+
+	private:
+		PipeStream(const std::shared_ptr<State>& state, bool writer);
+	};
+}
+
+#endif
\ No newline at end of file
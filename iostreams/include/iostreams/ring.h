@@ -0,0 +1,92 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_RING_H_
+#define _IOSTREAMS_RING_H_
+
+#include "iostreams/stream.h"
+#include <memory>
+
+namespace iostreams
+{
+	enum class RingOverflow : uint8_t
+	{
+		// drops the oldest bytes to make room
+		OVERWRITE = 0,
+		// waits until another thread consumes enough bytes
+		BLOCK
+	};
+
+	// Fixed-capacity circular stream. Offsets are absolute: size() is the number of bytes ever written and only
+	// [window_begin(), size()) is retained. write() always appends, tell() is the read cursor that read() and
+	// seek() move inside the window, consume() releases bytes from the front. The buffer is mapped twice back
+	// to back where the platform allows it (mirrored on every write otherwise), so a view never wraps.
+	// The stream is safe for one writing and one reading thread.
+	template<typename byte_type>
+	class RingStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+
+	private:
+		struct State;
+		std::unique_ptr<State> state_;
+
+	public:
+		// the capacity is rounded up to a multiple of the page size
+		explicit RingStream(count_type capacity, RingOverflow overflow = RingOverflow::OVERWRITE);
+
+		RingStream(RingStream&& stream);
+		RingStream& operator=(RingStream&& stream);
+
+		RingStream(const RingStream&) = delete;
+		RingStream& operator=(const RingStream&) = delete;
+
+		~RingStream();
+
+		count_type capacity() const;
+		RingOverflow overflow() const;
+
+		// the buffer is mapped twice instead of mirrored by copying
+		bool double_mapped() const;
+
+		size_type window_begin() const;
+		count_type window_size() const;
+
+		// contiguous span of [tell(), size()) or of [offset, offset + count) clipped to the window;
+		// with OVERWRITE the bytes may be replaced by later writes
+		ConstBuffer view() const;
+		ConstBuffer view(size_type offset, count_type count) const;
+
+		// releases count bytes from the front of the window
+		void consume(count_type count);
+
+		size_type size() const override;
+		size_type tell() const override;
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+
+		// shrinks the window from the back or appends zeros
+		void resize(size_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+
+		// overwrites retained bytes in place, appends when the range reaches past size() and zero-fills a gap
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,63 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_SLICE_H_
+#define _IOSTREAMS_SLICE_H_
+
+#include "iostreams/stream.h"
+#include <memory>
+
+namespace iostreams
+{
+	// [offset, offset + length) of another stream seen as a stream of its own. The parent is only accessed
+	// through pread and pwrite, so its position is never moved and several slices can share one parent.
+	// The slice has a fixed length: reads and writes are clipped to it. A range that reaches past the end of the
+	// parent is clipped to the parent's size when the slice is created.
+	template<typename byte_type>
+	class SliceStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+
+	private:
+		std::shared_ptr<IStream<byte_type>> stream_;
+		size_type offset_;
+		size_type length_;
+		size_type position_{ 0 };
+
+	public:
+		SliceStream(const std::shared_ptr<IStream<byte_type>>& stream, size_type offset, size_type length);
+
+		const std::shared_ptr<IStream<byte_type>>& stream() const { return stream_; }
+		size_type offset() const { return offset_; }
+
+		// a narrower slice of this one over the same parent
+		SliceStream slice(size_type offset, size_type length) const;
+
+		size_type size() const override { return length_; }
+		size_type tell() const override { return position_; }
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+
+		// only shrinks the slice, the parent is not modified
+		void resize(size_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_SPILL_H_
+#define _IOSTREAMS_SPILL_H_
+
+#include "iostreams/stream.h"
+#include "iostreams/memory.h"
+#include "iostreams/file.h"
+#include <memory>
+#include <string>
+
+namespace iostreams
+{
+	// Keeps the data in memory blocks while the stream fits into threshold bytes and moves it into an
+	// anonymous temporary file the first time a write or resize would grow it beyond the threshold.
+	template<typename byte_type>
+	class SpillStream : public IStream<byte_type>
+	{
+	public:
+		using size_type = typename IStream<byte_type>::size_type;
+		using count_type = typename IStream<byte_type>::count_type;
+		using off_type = typename IStream<byte_type>::off_type;
+		using Buffer = typename IStream<byte_type>::Buffer;
+		using ConstBuffer = typename IStream<byte_type>::ConstBuffer;
+
+	private:
+		size_type threshold_;
+		std::string directory_;
+		MemoryStream<byte_type> memory_;
+		std::unique_ptr<FileStream<byte_type>> file_;
+
+	public:
+		static constexpr size_type DEFAULT_THRESHOLD{ 64 * 1024 * 1024 };
+
+		SpillStream()
+			: SpillStream(SpillStream::DEFAULT_THRESHOLD)
+		{}
+
+		// an empty directory selects the system temporary directory
+		explicit SpillStream(size_type threshold, const std::string& directory = std::string());
+
+		SpillStream(SpillStream&&) = default;
+		SpillStream& operator=(SpillStream&&) = default;
+
+		SpillStream(const SpillStream&) = delete;
+		SpillStream& operator=(const SpillStream&) = delete;
+
+		size_type threshold() const { return threshold_; }
+		bool spilled() const { return file_ != nullptr; }
+
+		// moves the data into the temporary file regardless of the threshold
+		void spill();
+
+		size_type size() const override { return current()->size(); }
+		size_type tell() const override { return current()->tell(); }
+		std::string to_string(IToStringTransform<byte_type>& transformer) const override;
+		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg) override;
+		void resize(size_type size) override;
+		count_type read(byte_type* buffer, count_type count) override;
+		count_type write(const byte_type* data, count_type size) override;
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const override;
+		count_type pwrite(size_type offset, const byte_type* data, count_type size) override;
+		count_type readv(const Buffer* buffers, count_type count) override;
+		count_type writev(const ConstBuffer* buffers, count_type count) override;
+
+	private:
+		IStream<byte_type>* current() { return file_ ? static_cast<IStream<byte_type>*>(file_.get()) : &memory_; }
+		const IStream<byte_type>* current() const { return file_ ? static_cast<const IStream<byte_type>*>(file_.get()) : &memory_; }
+
+		void reserve(size_type size)
+		{
+			if (!file_ && size > threshold_)
+			{
+				spill();
+			}
+		}
+	};
+}
+
+#endif
\ No newline at end of file
@@ -30,6 +30,18 @@ namespace iostreams
 		using count_type = size_t;
 		using off_type = typename std::char_traits<byte_type>::off_type;
 
+		struct Buffer
+		{
+			byte_type* data;
+			count_type size;
+		};
+
+		struct ConstBuffer
+		{
+			const byte_type* data;
+			count_type size;
+		};
+
 		virtual ~IStream() {};
 		
 		virtual std::string to_string(IToStringTransform<byte_type>& transformer) const = 0;
@@ -40,6 +52,71 @@ namespace iostreams
 		virtual count_type write(const byte_type* data, count_type size) = 0;
 		virtual count_type read(byte_type* buffer, count_type count) = 0;
 
+		// positional read and write that never move the stream position. The fallback below seeks this stream
+		// and restores the position afterwards, so it is not thread-safe, not even pread; streams that override
+		// it with real positional I/O are safe for concurrent preads
+		virtual count_type pread(size_type offset, byte_type* buffer, count_type count) const
+		{
+			auto self = const_cast<IStream<byte_type>*>(this);
+
+			if (offset >= size())
+			{
+				return 0;
+			}
+
+			auto position = tell();
+			self->seek(static_cast<off_type>(offset));
+			auto read_bytes = self->read(buffer, count);
+			self->seek(static_cast<off_type>(position));
+			return read_bytes;
+		}
+
+		virtual count_type pwrite(size_type offset, const byte_type* data, count_type count)
+		{
+			auto position = tell();
+
+			if (offset > size())
+			{
+				resize(offset);
+			}
+
+			seek(static_cast<off_type>(offset));
+			auto written_bytes = write(data, count);
+			seek(static_cast<off_type>(position));
+			return written_bytes;
+		}
+
+		// scatter/gather at the current position; stops at the first short read
+		virtual count_type readv(const Buffer* buffers, count_type count)
+		{
+			count_type read_bytes{ 0 };
+
+			for (count_type i = 0; i < count; ++i)
+			{
+				auto bytes = read(buffers[i].data, buffers[i].size);
+				read_bytes += bytes;
+
+				if (bytes < buffers[i].size)
+				{
+					break;
+				}
+			}
+
+			return read_bytes;
+		}
+
+		virtual count_type writev(const ConstBuffer* buffers, count_type count)
+		{
+			count_type written_bytes{ 0 };
+
+			for (count_type i = 0; i < count; ++i)
+			{
+				written_bytes += write(buffers[i].data, buffers[i].size);
+			}
+
+			return written_bytes;
+		}
+
 		count_type read(off_type off, byte_type* buffer, count_type count)
 		{
 			seek(off);
@@ -80,5 +157,11 @@ namespace iostreams
 
 	template<typename byte_type>
 	void transform(IStream<byte_type>* source_stream, IStream<byte_type>* destination_stream, ITransform<byte_type, byte_type>& transformer);
+
+	// copies up to size bytes from the current position of the source to the current position of the destination
+	// and advances both. File to file copies stay in the kernel (copy_file_range, then sendfile) on Linux,
+	// a MemoryStream on either side is read or written directly from its blocks.
+	template<typename byte_type>
+	uint64_t copy(IStream<byte_type>* source_stream, IStream<byte_type>* destination_stream, uint64_t size);
 }
 #endif
\ No newline at end of file
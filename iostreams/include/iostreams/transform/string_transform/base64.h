@@ -17,12 +17,35 @@
 
 namespace iostreams
 {
+	enum class Base64Alphabet : uint8_t
+	{
+		STANDARD = 0,
+		// RFC 4648 "base64url": '-' and '_' in place of '+' and '/'
+		URL_SAFE
+	};
+
+	enum class LineBreak : uint8_t
+	{
+		CRLF = 0,
+		LF
+	};
+
+	struct Base64Options
+	{
+		Base64Alphabet alphabet{ Base64Alphabet::STANDARD };
+		bool padding{ true };
+		// characters per line, a multiple of 4 (MIME uses 76, PEM 64), 0 disables wrapping
+		uint32_t line_length{ 0 };
+		LineBreak line_break{ LineBreak::CRLF };
+	};
+
 	template<typename byte_type>
 	class FromBase64Transform : public IFromStringTransform<byte_type>
 	{
 	private:
 		uint8_t i_{ 0 };
-		char block4_[4];
+		uint8_t block4_[4];
+		Base64Alphabet alphabet_{ Base64Alphabet::STANDARD };
 
 	public:
 		using base_type = IFromStringTransform<byte_type>;
@@ -34,15 +57,33 @@ namespace iostreams
 			: base_type()
 		{}
 
-		FromBase64Transform(size_t buffer_size)
+		FromBase64Transform(Base64Alphabet alphabet)
+			: base_type()
+			, alphabet_(alphabet)
+		{}
+
+		FromBase64Transform(size_t buffer_size, Base64Alphabet alphabet = Base64Alphabet::STANDARD)
 			: base_type(buffer_size)
+			, alphabet_(alphabet)
 		{}
 
 		FromBase64Transform(const FromBase64Transform&) = default;
 		FromBase64Transform& operator=(const FromBase64Transform&) = default;
 
+		Base64Alphabet alphabet() const { return alphabet_; }
+
 		size_type required_size(size_type size) const override;
 
+		size_type split_unit() const override { return 4; }
+		size_type split_phase() const override { return i_; }
+		size_type significant_size(const char* data, size_type size) const override;
+		std::unique_ptr<StringTransform<char, byte_type>> fork() const override;
+
+		bool supports_transform_into() const override { return true; }
+		TransformResult transform_into(const char* data, size_type size, byte_type* output, size_type capacity) override;
+		size_type finish_into(byte_type* output, size_type capacity) override;
+		size_type final_size() const override { return 2; }
+
 		void update(const char* data, size_type size, const transform_handler& handler) override;
 		void update_final(const transform_handler& handler) override;
 	};
@@ -51,9 +92,10 @@ namespace iostreams
 	class ToBase64Transform : public IToStringTransform<byte_type>
 	{
 	private:
-		//todo: InsertLineBreaks
 		uint8_t i_{ 0 };
 		uint8_t block3_[3];
+		Base64Options options_;
+		uint32_t column_{ 0 };
 
 	public:
 		using base_type = IToStringTransform<byte_type>;
@@ -65,17 +107,37 @@ namespace iostreams
 			: base_type()
 		{}
 
-		ToBase64Transform(size_t buffer_size)
-			: base_type(buffer_size)
+		ToBase64Transform(const Base64Options& options)
+			: ToBase64Transform(base_type::BUFFER_SIZE, options)
 		{}
 
+		ToBase64Transform(size_t buffer_size, const Base64Options& options = Base64Options());
+
 		ToBase64Transform(const ToBase64Transform&) = default;
 		ToBase64Transform& operator=(const ToBase64Transform&) = default;
 
-		size_type required_size(size_type size) const override { return size / 3 * 4 + (size % 3 != 0 ? 4 : 0); }
+		const Base64Options& options() const { return options_; }
+
+		size_type required_size(size_type size) const override;
+
+		// with line wrapping the pieces are whole lines
+		size_type split_unit() const override { return options_.line_length != 0 ? options_.line_length / 4 * 3 : 3; }
+		size_type split_phase() const override;
+		std::unique_ptr<StringTransform<byte_type, char>> fork() const override;
+
+		bool supports_transform_into() const override { return true; }
+		TransformResult transform_into(const byte_type* data, size_type size, char* output, size_type capacity) override;
+		size_type finish_into(char* output, size_type capacity) override;
+		// the last block and the line break in front of it
+		size_type final_size() const override { return 6; }
 
 		void update(const byte_type* data, size_type size, const transform_handler& handler) override;
 		void update_final(const transform_handler& handler) override;
+
+	private:
+		size_type line_break_size() const;
+		size_type put_line_break(char* output);
+		size_type put_block(char* output);
 	};
 }
-#endif
+#endif
\ No newline at end of file
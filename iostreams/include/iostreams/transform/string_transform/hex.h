@@ -17,10 +17,18 @@
 
 namespace iostreams
 {
-	//todo: hex string format
+	enum class HexFormat : uint8_t
+	{
+		LOWERCASE = 0,
+		UPPERCASE
+	};
+
 	template<typename byte_type>
 	class ToHexTransform : public IToStringTransform<byte_type>
 	{
+	private:
+		HexFormat format_{ HexFormat::LOWERCASE };
+
 	public:
 		using base_type = IToStringTransform<byte_type>;
 		using value_type = byte_type;
@@ -31,15 +39,30 @@ namespace iostreams
 			: base_type()
 		{}
 
-		ToHexTransform(size_t buffer_size)
+		ToHexTransform(HexFormat format)
+			: base_type()
+			, format_(format)
+		{}
+
+		ToHexTransform(size_t buffer_size, HexFormat format = HexFormat::LOWERCASE)
 			: base_type(buffer_size)
+			, format_(format)
 		{}
 
 		ToHexTransform(const ToHexTransform&) = default;
 		ToHexTransform& operator=(const ToHexTransform&) = default;
 
+		HexFormat format() const { return format_; }
+
 		size_type required_size(size_type size) const override { return size * 2; }
 
+		size_type split_unit() const override { return 1; }
+		std::unique_ptr<StringTransform<byte_type, char>> fork() const override;
+
+		bool supports_transform_into() const override { return true; }
+		TransformResult transform_into(const byte_type* data, size_type size, char* output, size_type capacity) override;
+		size_type finish_into(char*, size_type) override { return 0; }
+
 		void update(const byte_type* data, size_type size, const transform_handler& handler) override;
 		void update_final(const transform_handler& handler) override;
 	};
@@ -49,6 +72,8 @@ namespace iostreams
 	{
 	private:
 		char ch_{ 0 };
+		uint64_t offset_{ 0 };
+		uint64_t error_offset_{ NO_ERROR_OFFSET };
 
 	public:
 		using base_type = IFromStringTransform<byte_type>;
@@ -56,6 +81,8 @@ namespace iostreams
 		using size_type = typename base_type::size_type;
 		using transform_handler = typename base_type::TransformHandler;
 
+		static constexpr uint64_t NO_ERROR_OFFSET{ UINT64_MAX };
+
 		FromHexTransform()
 			: base_type()
 		{}
@@ -67,8 +94,21 @@ namespace iostreams
 		FromHexTransform(const FromHexTransform&) = default;
 		FromHexTransform& operator=(const FromHexTransform&) = default;
 
+		// offset of the invalid character that made update throw BAD_HEX_CHARACTER, counted from the first
+		// update after construction or update_final
+		uint64_t error_offset() const { return error_offset_; }
+
 		size_type required_size(size_type size) const override;
 
+		size_type split_unit() const override { return 2; }
+		size_type split_phase() const override { return ch_ != 0 ? 1 : 0; }
+		size_type significant_size(const char* data, size_type size) const override;
+		std::unique_ptr<StringTransform<char, byte_type>> fork() const override;
+
+		bool supports_transform_into() const override { return true; }
+		TransformResult transform_into(const char* data, size_type size, byte_type* output, size_type capacity) override;
+		size_type finish_into(byte_type* output, size_type capacity) override;
+
 		void update(const char* data, size_type size, const transform_handler& handler) override;
 		void update_final(const transform_handler& handler) override;
 	};
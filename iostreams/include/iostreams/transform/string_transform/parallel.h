@@ -0,0 +1,38 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_TRANSFORM_PARALLEL_H_
+#define _IOSTREAMS_TRANSFORM_PARALLEL_H_
+
+#include "iostreams/transform/string_transform/string_transform.h"
+
+namespace iostreams
+{
+	struct ParallelOptions
+	{
+		// threads working on one call including the calling one, 0 for one per hardware thread
+		uint32_t threads{ 0 };
+		// the smallest piece given to a thread, inputs shorter than two pieces are transformed sequentially
+		size_t chunk_size{ 1024 * 1024 };
+	};
+
+	// Does what transformer.update(data, size, handler) does, using several threads for large inputs. The input
+	// is cut on block boundaries (see StringTransform::split_unit). The calling thread feeds the first piece to
+	// transformer, forks of it transform the others into slices of one buffer sized with required_size, and the
+	// slices are passed to the handler in order. What follows the last whole block goes to transformer again,
+	// so it keeps the same state as after a sequential update and the caller may go on with update and
+	// update_final. Transforms that cannot be split are run sequentially. A failure in any piece is rethrown once
+	// all of them have finished.
+	template<typename source_type, typename destination_type>
+	void parallel_update(StringTransform<source_type, destination_type>& transformer, const source_type* data, size_t size,
+		const typename StringTransform<source_type, destination_type>::transform_handler& handler, const ParallelOptions& options = ParallelOptions());
+}
+#endif
\ No newline at end of file
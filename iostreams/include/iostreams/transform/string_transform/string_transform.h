@@ -13,10 +13,19 @@
 #define _IOSTREAMS_STRING_TRANSFORM_H_
 
 #include "iostreams/transform/transform.h"
+#include "iostreams/error.h"
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace iostreams
 {
+	struct TransformResult
+	{
+		size_t consumed{ 0 };
+		size_t produced{ 0 };
+	};
+
 	template<typename source_type, typename destination_type>
 	class StringTransform : public ITransform<source_type, destination_type>
 	{
@@ -34,6 +43,71 @@ namespace iostreams
 	public:
 		virtual size_type required_size(size_type size) const = 0;
 
+		// Hooks for parallel_update (parallel.h), which cuts large inputs on block boundaries and gives the pieces
+		// to fresh copies of the transform. split_unit() is the number of significant source elements in a block,
+		// 0 if the transform cannot be split. split_phase() is the number of significant elements consumed since
+		// the last boundary. significant_size() counts the elements of a range that are not skipped (line breaks,
+		// whitespace, padding). fork() makes a copy with the same settings that continues after a boundary.
+		virtual size_type split_unit() const { return 0; }
+		virtual size_type split_phase() const { return 0; }
+		virtual size_type significant_size(const source_type*, size_type size) const { return size; }
+		virtual std::unique_ptr<StringTransform> fork() const { return nullptr; }
+
+		// Direct output: transform_into() writes straight into the caller's memory instead of the buffer and the
+		// handler. It consumes the data up to the first block whose output does not fit and keeps a partial block
+		// for the next call, as update() does. finish_into() writes what update_final() would, at most
+		// final_size() elements, and resets the transform. Output update() left in the buffer is not included,
+		// flush() it first. Transforms that write only through update() return false from supports_transform_into().
+		virtual bool supports_transform_into() const { return false; }
+
+		virtual TransformResult transform_into(const source_type*, size_type, destination_type*, size_type)
+		{
+			throw IOStreamsException(errors::NOT_SUPPORTED);
+		}
+
+		virtual size_type finish_into(destination_type*, size_type)
+		{
+			throw IOStreamsException(errors::NOT_SUPPORTED);
+		}
+
+		virtual size_type final_size() const { return 0; }
+
+		// update() and update_final() with any callable as the sink, called directly rather than through std::function
+		template<typename sink_type>
+		void update_with(const source_type* data, size_type size, sink_type&& sink)
+		{
+			if (!supports_transform_into())
+			{
+				this->update(data, size, sink);
+				return;
+			}
+
+			update_into_buffer(data, size, sink);
+		}
+
+		template<typename sink_type>
+		void update_final_with(sink_type&& sink)
+		{
+			if (!supports_transform_into())
+			{
+				this->update_final(sink);
+				return;
+			}
+
+			final_into_buffer(sink);
+		}
+
+		// passes the buffered output to the handler
+		void flush(const transform_handler& handler)
+		{
+			if (handler != nullptr)
+			{
+				handler(buffer_.data(), buffer_index_);
+			}
+
+			buffer_index_ = 0;
+		}
+
 	protected:
 		StringTransform()
 			: StringTransform(StringTransform::BUFFER_SIZE)
@@ -46,15 +120,60 @@ namespace iostreams
 		StringTransform(const StringTransform&) = default;
 		StringTransform& operator=(const StringTransform&) = default;
 
-		void flush(const transform_handler& handler)
+		// update() and update_final() of the transforms with direct output, through the buffer
+		template<typename sink_type>
+		void update_into_buffer(const source_type* data, size_type size, sink_type& sink)
 		{
-			if (handler != nullptr)
+			if (data == nullptr)
 			{
-				handler(buffer_.data(), buffer_index_);
+				return;
+			}
+
+			while (size > 0)
+			{
+				auto result = transform_into(data, size, buffer_.data() + buffer_index_, buffer_.size() - buffer_index_);
+				data += result.consumed;
+				size -= result.consumed;
+				buffer_index_ += result.produced;
+
+				if (size > 0)
+				{
+					THROW_IF(result.consumed == 0 && buffer_index_ == 0, IOStreamsException(errors::BUFFER_TOO_SMALL));
+					emit(sink);
+				}
+			}
+		}
+
+		template<typename sink_type>
+		void final_into_buffer(sink_type& sink)
+		{
+			if (buffer_.size() - buffer_index_ < final_size())
+			{
+				emit(sink);
 			}
 
+			buffer_index_ += finish_into(buffer_.data() + buffer_index_, buffer_.size() - buffer_index_);
+			emit(sink);
+		}
+
+	private:
+		template<typename sink_type>
+		void emit(sink_type& sink)
+		{
+			sink(buffer_.data(), buffer_index_);
 			buffer_index_ = 0;
 		}
+
+		// a std::function handler can be empty
+		void emit(const transform_handler& handler)
+		{
+			flush(handler);
+		}
+
+		void emit(transform_handler& handler)
+		{
+			flush(handler);
+		}
 	};
 
 	template<typename byte_type>
@@ -92,5 +211,58 @@ namespace iostreams
 		IToStringTransform(const IToStringTransform&) = default;
 		IToStringTransform& operator=(const IToStringTransform&) = default;
 	};
+
+	// Appends the transformed data to result. Transforms with direct output write into the string itself,
+	// growing it by the required_size() estimate, the others go through update().
+	template<typename byte_type>
+	void transform_to_string(IToStringTransform<byte_type>& transformer, const byte_type* data, size_t size, std::string& result)
+	{
+		if (!transformer.supports_transform_into())
+		{
+			transformer.update(data, size, [&result](const char* output, size_t count)
+			{
+				result.append(output, count);
+			});
+
+			return;
+		}
+
+		auto length = result.size();
+
+		while (data != nullptr && size > 0)
+		{
+			// a partial block left from the previous call can need more than the estimate, the space then
+			// keeps growing until the next block fits
+			auto growth = transformer.required_size(size) + transformer.final_size();
+			result.resize(result.size() + growth);
+
+			auto transformed = transformer.transform_into(data, size, &result[length], result.size() - length);
+			THROW_IF(transformed.consumed == 0 && growth == 0, IOStreamsException(errors::BUFFER_TOO_SMALL));
+			data += transformed.consumed;
+			size -= transformed.consumed;
+			length += transformed.produced;
+		}
+
+		result.resize(length);
+	}
+
+	// appends what update_final() gives to result
+	template<typename byte_type>
+	void finish_to_string(IToStringTransform<byte_type>& transformer, std::string& result)
+	{
+		if (!transformer.supports_transform_into())
+		{
+			transformer.update_final([&result](const char* data, size_t size)
+			{
+				result.append(data, size);
+			});
+
+			return;
+		}
+
+		auto length = result.size();
+		result.resize(length + transformer.final_size());
+		result.resize(length + transformer.finish_into(&result[length], transformer.final_size()));
+	}
 }
 #endif
\ No newline at end of file
@@ -26,6 +26,8 @@ namespace iostreams
 		using size_type = size_t;
 		using TransformHandler = std::function<void(const destination_type* data, size_type size)>;
 
+		virtual ~ITransform() = default;
+
 		virtual void update(const source_type* data, size_type size, const TransformHandler& handler) = 0;
 		virtual void update_final(const TransformHandler& handler) = 0;
 	};
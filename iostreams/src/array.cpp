@@ -12,6 +12,7 @@
 #include "iostreams/array.h"
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace iostreams
 {
@@ -71,15 +72,9 @@ namespace iostreams
 			THROW_IF(data_size > result.max_size(), IOStreamsException(errors::STREAM_SIZE_TOO_BIG));
 			result.reserve(transformer.required_size(data_size));
 
-			transformer.update(data_.data(), data_size, [&result](const char* data, count_type size)
-			{
-				result.insert(result.end(), data, data + size);
-			});
+			transform_to_string(transformer, data_.data(), data_size, result);
 
-			transformer.update_final([&result](const char* data, count_type size)
-			{
-				result.insert(result.end(), data, data + size);
-			});
+			finish_to_string(transformer, result);
 		}
 
 		return result;
@@ -121,34 +116,229 @@ namespace iostreams
 	template<typename byte_type>
 	typename ArrayStream<byte_type>::count_type ArrayStream<byte_type>::write(const byte_type* data, count_type size)
 	{
-		if (data_.size() < position_ + size)
-		{
-			data_.resize(static_cast<size_t>(position_ + size));
-		}
-
-		std::memcpy(data_.data() + position_, data, static_cast<size_t>(size));
-		position_ += size;
-		return size;
+		auto written_bytes = pwrite(position_, data, size);
+		position_ += written_bytes;
+		return written_bytes;
 	}
 
 	template<typename byte_type>
 	typename ArrayStream<byte_type>::count_type ArrayStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		auto read_bytes = pread(position_, buffer, count);
+		position_ += read_bytes;
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename ArrayStream<byte_type>::count_type ArrayStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
 	{
 		assert(buffer != nullptr);
 
 		count_type read_bytes{ 0 };
 		const auto data_size = size();
 
-		if (data_size > 0 && position_ < data_size)
+		if (offset < data_size)
 		{
-			read_bytes = std::min<count_type>(count, static_cast<count_type>(data_size - position_));
-			std::memcpy(buffer, data_.data() + position_, read_bytes);
-			position_ += read_bytes;
+			read_bytes = static_cast<count_type>(std::min<size_type>(count, data_size - offset));
+			std::memcpy(buffer, data_.data() + offset, read_bytes);
 		}
 
 		return read_bytes;
 	}
 
+	template<typename byte_type>
+	typename ArrayStream<byte_type>::count_type ArrayStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type size)
+	{
+		if (data_.size() < offset + size)
+		{
+			data_.resize(static_cast<size_t>(offset + size));
+		}
+
+		std::memcpy(data_.data() + offset, data, static_cast<size_t>(size));
+		return size;
+	}
+
+	template<typename byte_type>
+	typename ArrayStream<byte_type>::count_type ArrayStream<byte_type>::readv(const Buffer* buffers, count_type count)
+	{
+		count_type read_bytes{ 0 };
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			auto bytes = pread(position_, buffers[i].data, buffers[i].size);
+			position_ += bytes;
+			read_bytes += bytes;
+
+			if (bytes < buffers[i].size)
+			{
+				break;
+			}
+		}
+
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename ArrayStream<byte_type>::count_type ArrayStream<byte_type>::writev(const ConstBuffer* buffers, count_type count)
+	{
+		count_type total{ 0 };
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			total += buffers[i].size;
+		}
+
+		if (data_.size() < position_ + total)
+		{
+			data_.resize(static_cast<size_t>(position_ + total));
+		}
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			std::memcpy(data_.data() + position_, buffers[i].data, static_cast<size_t>(buffers[i].size));
+			position_ += buffers[i].size;
+		}
+
+		return total;
+	}
+
+	template<typename byte_type>
+	ConstArrayStream<byte_type>::ConstArrayStream(const byte_type* data, size_type size)
+		: data_(data, [](const byte_type*) {})
+		, size_(size)
+	{}
+
+	template<typename byte_type>
+	ConstArrayStream<byte_type>::ConstArrayStream(const byte_type* data, size_type size, deleter_type deleter)
+		: size_(size)
+	{
+		if (deleter)
+		{
+			data_ = std::shared_ptr<const byte_type>(data, std::move(deleter));
+		}
+		else
+		{
+			data_ = std::shared_ptr<const byte_type>(data, [](const byte_type*) {});
+		}
+	}
+
+	template<typename byte_type>
+	ConstArrayStream<byte_type>::ConstArrayStream(const std::shared_ptr<const byte_type>& data, size_type size)
+		: data_(data)
+		, size_(size)
+	{}
+
+	template<typename byte_type>
+	ConstArrayStream<byte_type>::ConstArrayStream(std::vector<byte_type>&& data)
+		: size_(static_cast<size_type>(data.size()))
+	{
+		auto holder = std::make_shared<const std::vector<byte_type>>(std::move(data));
+		data_ = std::shared_ptr<const byte_type>(holder, holder->data());
+	}
+
+	template<typename byte_type>
+	std::string ConstArrayStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		std::string result;
+
+		if (size_ > 0)
+		{
+			THROW_IF(size_ > result.max_size(), IOStreamsException(errors::STREAM_SIZE_TOO_BIG));
+			result.reserve(transformer.required_size(size_));
+
+			transform_to_string(transformer, data_.get(), size_, result);
+
+			finish_to_string(transformer, result);
+		}
+
+		return result;
+	}
+
+	template<typename byte_type>
+	void ConstArrayStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		if (way == std::ios_base::cur)
+		{
+			off += static_cast<off_type>(position_);
+		}
+		else if (way == std::ios_base::end)
+		{
+			off += static_cast<off_type>(size_);
+		}
+
+		THROW_IF(off < 0 || static_cast<size_type>(off) > size_, IOStreamsException(errors::OUT_OF_RANGE));
+		position_ = static_cast<size_type>(off);
+	}
+
+	template<typename byte_type>
+	void ConstArrayStream<byte_type>::resize(size_type)
+	{
+		throw IOStreamsException(errors::STREAM_READ_ONLY);
+	}
+
+	template<typename byte_type>
+	typename ConstArrayStream<byte_type>::count_type ConstArrayStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		auto read_bytes = pread(position_, buffer, count);
+		position_ += read_bytes;
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename ConstArrayStream<byte_type>::count_type ConstArrayStream<byte_type>::write(const byte_type*, count_type)
+	{
+		throw IOStreamsException(errors::STREAM_READ_ONLY);
+	}
+
+	template<typename byte_type>
+	typename ConstArrayStream<byte_type>::count_type ConstArrayStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		assert(buffer != nullptr);
+		count_type read_bytes{ 0 };
+
+		if (offset < size_)
+		{
+			read_bytes = static_cast<count_type>(std::min<size_type>(count, size_ - offset));
+			std::memcpy(buffer, data_.get() + offset, read_bytes);
+		}
+
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename ConstArrayStream<byte_type>::count_type ConstArrayStream<byte_type>::pwrite(size_type, const byte_type*, count_type)
+	{
+		throw IOStreamsException(errors::STREAM_READ_ONLY);
+	}
+
+	template<typename byte_type>
+	typename ConstArrayStream<byte_type>::count_type ConstArrayStream<byte_type>::readv(const Buffer* buffers, count_type count)
+	{
+		count_type read_bytes{ 0 };
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			auto bytes = pread(position_, buffers[i].data, buffers[i].size);
+			position_ += bytes;
+			read_bytes += bytes;
+
+			if (bytes < buffers[i].size)
+			{
+				break;
+			}
+		}
+
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename ConstArrayStream<byte_type>::count_type ConstArrayStream<byte_type>::writev(const ConstBuffer*, count_type)
+	{
+		throw IOStreamsException(errors::STREAM_READ_ONLY);
+	}
+
 	template class ArrayStream<uint8_t>;
 	template class ArrayStream<char>;
+	template class ConstArrayStream<uint8_t>;
+	template class ConstArrayStream<char>;
 }
\ No newline at end of file
@@ -0,0 +1,815 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifdef __linux__
+
+#include "iostreams/async_file.h"
+#include "iostreams/error.h"
+#include "liberror/exception.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined (__has_include)
+	#if __has_include(<linux/io_uring.h>)
+		#include <linux/io_uring.h>
+		#define IOSTREAMS_IO_URING
+	#endif
+#endif
+
+#define CHECK_STREAM_STATE if (is_close_) throw IOStreamsException(errors::STREAM_CLOSE)
+
+namespace iostreams
+{
+	struct AsyncIOService::Operation
+	{
+		int fd;
+		bool write;
+		AsyncIOService::size_type offset;
+		iovec iov;
+		AsyncIOService::callback_type callback;
+		AsyncIOService::count_type transferred{ 0 };
+
+		// moves past a short transfer, true if a part is left
+		bool advance(AsyncIOService::count_type count)
+		{
+			transferred += count;
+			offset += count;
+			iov.iov_base = static_cast<uint8_t*>(iov.iov_base) + count;
+			iov.iov_len -= count;
+			return iov.iov_len > 0;
+		}
+
+		// synchronous execution used by the thread pool
+		AsyncIOService::count_type run() const
+		{
+			auto buffer = static_cast<uint8_t*>(iov.iov_base);
+			AsyncIOService::count_type transferred_bytes{ 0 };
+
+			while (transferred_bytes < iov.iov_len)
+			{
+				auto ret = write
+					? ::pwrite64(fd, buffer + transferred_bytes, iov.iov_len - transferred_bytes, offset + transferred_bytes)
+					: ::pread64(fd, buffer + transferred_bytes, iov.iov_len - transferred_bytes, offset + transferred_bytes);
+
+				if (ret == -1)
+				{
+					THROW_IF(errno != EINTR, POSIX_ERROR(write ? "pwrite" : "pread"));
+					continue;
+				}
+
+				if (ret == 0)
+				{
+					break;
+				}
+
+				transferred_bytes += static_cast<AsyncIOService::count_type>(ret);
+			}
+
+			return transferred_bytes;
+		}
+
+		void complete(AsyncIOService::count_type count, std::exception_ptr error) const
+		{
+			try
+			{
+				callback(count, error);
+			}
+			catch (...)
+			{}
+		}
+	};
+
+	class AsyncIOService::Impl
+	{
+	public:
+		virtual ~Impl() {}
+		virtual void queue(std::unique_ptr<Operation> operation) = 0;
+		virtual void submit() = 0;
+	};
+
+#ifdef IOSTREAMS_IO_URING
+	class AsyncIOService::IoUringImpl : public AsyncIOService::Impl
+	{
+	private:
+		int ring_fd_{ -1 };
+
+		void* sq_ring_{ MAP_FAILED };
+		size_t sq_ring_size_{ 0 };
+		void* cq_ring_{ MAP_FAILED };
+		size_t cq_ring_size_{ 0 };
+		io_uring_sqe* sqes_{ static_cast<io_uring_sqe*>(MAP_FAILED) };
+		size_t sqes_size_{ 0 };
+
+		unsigned* sq_head_{ nullptr };
+		unsigned* sq_tail_{ nullptr };
+		unsigned* sq_array_{ nullptr };
+		unsigned sq_mask_{ 0 };
+		unsigned sq_entries_{ 0 };
+
+		unsigned* cq_head_{ nullptr };
+		unsigned* cq_tail_{ nullptr };
+		io_uring_cqe* cqes_{ nullptr };
+		unsigned cq_mask_{ 0 };
+		unsigned cq_entries_{ 0 };
+
+		std::mutex mutex_;
+		std::condition_variable capacity_cv_;
+		unsigned queued_{ 0 };
+		unsigned in_flight_{ 0 };
+		// operations queued by callbacks while the ring was at capacity, pushed once completions free a slot
+		std::deque<std::unique_ptr<Operation>> backlog_;
+		bool stop_{ false };
+		std::thread completion_thread_;
+
+	public:
+		explicit IoUringImpl(unsigned queue_depth)
+		{
+			io_uring_params params;
+			std::memset(&params, 0, sizeof(params));
+			ring_fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, queue_depth, &params));
+			THROW_IF(ring_fd_ < 0, POSIX_ERROR("io_uring_setup"));
+
+			try
+			{
+				map_rings(params);
+			}
+			catch (...)
+			{
+				release();
+				throw;
+			}
+
+			completion_thread_ = std::thread(&IoUringImpl::complete, this);
+		}
+
+		~IoUringImpl()
+		{
+			try
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				// the wake-up needs a completion slot of its own
+				capacity_cv_.wait(lock, [this]() { return in_flight_ < cq_entries_; });
+				stop_ = true;
+				push(nullptr, IORING_OP_NOP);
+				enter();
+			}
+			catch (...)
+			{}
+
+			completion_thread_.join();
+			release();
+		}
+
+		void queue(std::unique_ptr<Operation> operation) override
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			// more operations in flight than the completion ring holds would overflow it
+			if (in_flight_ >= cq_entries_ || !backlog_.empty())
+			{
+				// a callback queueing more I/O runs on the completion thread, which is the one that frees the slots
+				if (on_completion_thread())
+				{
+					backlog_.push_back(std::move(operation));
+					return;
+				}
+
+				enter();
+				capacity_cv_.wait(lock, [this]() { return in_flight_ < cq_entries_ && backlog_.empty(); });
+			}
+
+			start(std::move(operation));
+		}
+
+		void submit() override
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			enter();
+		}
+
+	private:
+		void map_rings(const io_uring_params& params)
+		{
+			sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+			if (single_mmap)
+			{
+				sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+			}
+
+			sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+			THROW_IF(sq_ring_ == MAP_FAILED, POSIX_ERROR("mmap"));
+
+			if (single_mmap)
+			{
+				cq_ring_ = sq_ring_;
+			}
+			else
+			{
+				cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+				THROW_IF(cq_ring_ == MAP_FAILED, POSIX_ERROR("mmap"));
+			}
+
+			sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+			sqes_ = static_cast<io_uring_sqe*>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+			THROW_IF(sqes_ == MAP_FAILED, POSIX_ERROR("mmap"));
+
+			auto sq = static_cast<uint8_t*>(sq_ring_);
+			sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+			sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+			sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+			sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+			sq_entries_ = params.sq_entries;
+
+			auto cq = static_cast<uint8_t*>(cq_ring_);
+			cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+			cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+			cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+			cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+			cq_entries_ = params.cq_entries;
+		}
+
+		void release()
+		{
+			if (sqes_ != MAP_FAILED)
+			{
+				::munmap(sqes_, sqes_size_);
+			}
+
+			if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+			{
+				::munmap(cq_ring_, cq_ring_size_);
+			}
+
+			if (sq_ring_ != MAP_FAILED)
+			{
+				::munmap(sq_ring_, sq_ring_size_);
+			}
+
+			if (ring_fd_ != -1)
+			{
+				::close(ring_fd_);
+			}
+		}
+
+		// must be called under mutex_; a full submission ring is handed to the kernel first
+		void push(Operation* operation, uint8_t opcode)
+		{
+			auto tail = *sq_tail_;
+
+			if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_)
+			{
+				enter();
+			}
+
+			auto index = tail & sq_mask_;
+			auto& sqe = sqes_[index];
+			std::memset(&sqe, 0, sizeof(sqe));
+			sqe.opcode = opcode;
+			sqe.user_data = reinterpret_cast<uint64_t>(operation);
+
+			if (operation != nullptr)
+			{
+				sqe.fd = operation->fd;
+				sqe.off = operation->offset;
+				sqe.addr = reinterpret_cast<uint64_t>(&operation->iov);
+				sqe.len = 1;
+			}
+
+			sq_array_[index] = index;
+			__atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+			++queued_;
+		}
+
+		// must be called under mutex_, hands the queued entries to the kernel
+		void enter()
+		{
+			while (queued_ > 0)
+			{
+				auto ret = static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_, queued_, 0, 0, nullptr, 0));
+
+				if (ret == -1)
+				{
+					THROW_IF(errno != EINTR && errno != EAGAIN && errno != EBUSY, POSIX_ERROR("io_uring_enter"));
+
+					// EBUSY waits for the completion ring to be reaped, the completion thread retries after that
+					if (errno == EBUSY && on_completion_thread())
+					{
+						return;
+					}
+
+					std::this_thread::yield();
+					continue;
+				}
+
+				queued_ -= static_cast<unsigned>(ret);
+			}
+		}
+
+		// must be called under mutex_
+		void start(std::unique_ptr<Operation> operation)
+		{
+			push(operation.get(), operation->write ? IORING_OP_WRITEV : IORING_OP_READV);
+			operation.release();
+			++in_flight_;
+		}
+
+		bool on_completion_thread() const
+		{
+			return std::this_thread::get_id() == completion_thread_.get_id();
+		}
+
+		void complete()
+		{
+			while (true)
+			{
+				auto head = *cq_head_;
+				auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+
+				if (head == tail)
+				{
+					{
+						std::unique_lock<std::mutex> lock(mutex_);
+
+						while (!backlog_.empty() && in_flight_ < cq_entries_)
+						{
+							start(std::move(backlog_.front()));
+							backlog_.pop_front();
+						}
+
+						enter();
+
+						if (stop_ && in_flight_ == 0)
+						{
+							break;
+						}
+					}
+
+					capacity_cv_.notify_all();
+
+					::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+					continue;
+				}
+
+				for (; head != tail; ++head)
+				{
+					auto cqe = cqes_[head & cq_mask_];
+					__atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+					std::unique_ptr<Operation> operation(reinterpret_cast<Operation*>(cqe.user_data));
+
+					if (operation == nullptr)
+					{
+						continue;
+					}
+
+					{
+						// the operation was pushed under the mutex as well
+						std::unique_lock<std::mutex> lock(mutex_);
+
+						// like the thread pool, interrupted and short transfers continue until the end of the file
+						if (cqe.res == -EINTR || cqe.res == -EAGAIN || (cqe.res > 0 && operation->advance(static_cast<AsyncIOService::count_type>(cqe.res))))
+						{
+							push(operation.get(), operation->write ? IORING_OP_WRITEV : IORING_OP_READV);
+							operation.release();
+							enter();
+							continue;
+						}
+
+						// the slot is released before the callback, which may queue more I/O
+						--in_flight_;
+					}
+
+					capacity_cv_.notify_all();
+
+					if (cqe.res < 0)
+					{
+						errno = -cqe.res;
+						operation->complete(0, std::make_exception_ptr(POSIX_ERROR(operation->write ? "pwrite" : "pread")));
+					}
+					else
+					{
+						operation->complete(operation->transferred, nullptr);
+					}
+				}
+			}
+		}
+	};
+#endif
+
+	class AsyncIOService::ThreadPoolImpl : public AsyncIOService::Impl
+	{
+	private:
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		std::vector<std::unique_ptr<Operation>> queued_;
+		std::deque<std::unique_ptr<Operation>> submitted_;
+		std::vector<std::thread> workers_;
+		bool stop_{ false };
+
+	public:
+		explicit ThreadPoolImpl(unsigned thread_count)
+		{
+			for (auto i = std::max(thread_count, 1u); i > 0; --i)
+			{
+				workers_.emplace_back(&ThreadPoolImpl::work, this);
+			}
+		}
+
+		~ThreadPoolImpl()
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				move_queued();
+				stop_ = true;
+			}
+
+			cv_.notify_all();
+
+			for (auto& worker : workers_)
+			{
+				worker.join();
+			}
+		}
+
+		void queue(std::unique_ptr<Operation> operation) override
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			queued_.push_back(std::move(operation));
+		}
+
+		void submit() override
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				move_queued();
+			}
+
+			cv_.notify_all();
+		}
+
+	private:
+		void move_queued()
+		{
+			for (auto& operation : queued_)
+			{
+				submitted_.push_back(std::move(operation));
+			}
+
+			queued_.clear();
+		}
+
+		void work()
+		{
+			while (true)
+			{
+				std::unique_ptr<Operation> operation;
+
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					cv_.wait(lock, [this]() { return stop_ || !submitted_.empty(); });
+
+					if (submitted_.empty())
+					{
+						break;
+					}
+
+					operation = std::move(submitted_.front());
+					submitted_.pop_front();
+				}
+
+				try
+				{
+					auto count = operation->run();
+					operation->complete(count, nullptr);
+				}
+				catch (...)
+				{
+					operation->complete(0, std::current_exception());
+				}
+			}
+		}
+	};
+
+	AsyncIOService::AsyncIOService(AsyncEngine engine, unsigned queue_depth, unsigned thread_count)
+		: engine_(AsyncEngine::THREAD_POOL)
+	{
+#ifdef IOSTREAMS_IO_URING
+		if (engine != AsyncEngine::THREAD_POOL)
+		{
+			try
+			{
+				pimpl_.reset(new IoUringImpl(queue_depth));
+				engine_ = AsyncEngine::IO_URING;
+			}
+			catch (...)
+			{
+				if (engine == AsyncEngine::IO_URING)
+				{
+					throw;
+				}
+			}
+		}
+#else
+		THROW_IF(engine == AsyncEngine::IO_URING, IOStreamsException(errors::NOT_SUPPORTED));
+#endif
+
+		if (!pimpl_)
+		{
+			pimpl_.reset(new ThreadPoolImpl(thread_count));
+		}
+	}
+
+	AsyncIOService::~AsyncIOService()
+	{}
+
+	void AsyncIOService::read(int fd, size_type offset, void* buffer, count_type count, callback_type callback)
+	{
+		assert(buffer != nullptr);
+		std::unique_ptr<Operation> operation(new Operation{ fd, false, offset, { buffer, count }, std::move(callback) });
+		pimpl_->queue(std::move(operation));
+	}
+
+	void AsyncIOService::write(int fd, size_type offset, const void* data, count_type count, callback_type callback)
+	{
+		assert(data != nullptr);
+		std::unique_ptr<Operation> operation(new Operation{ fd, true, offset, { const_cast<void*>(data), count }, std::move(callback) });
+		pimpl_->queue(std::move(operation));
+	}
+
+	void AsyncIOService::submit()
+	{
+		pimpl_->submit();
+	}
+
+	template<typename byte_type>
+	struct AsyncFileStream<byte_type>::PendingOperations
+	{
+		std::mutex mutex;
+		std::condition_variable cv;
+		size_t count{ 0 };
+
+		void acquire()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			++count;
+		}
+
+		void release()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			if (--count == 0)
+			{
+				cv.notify_all();
+			}
+		}
+
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [this]() { return count == 0; });
+		}
+	};
+
+	template<typename byte_type>
+	AsyncFileStream<byte_type>::AsyncFileStream(FileStream<byte_type>&& file, const std::shared_ptr<AsyncIOService>& service)
+		: file_(std::move(file))
+		, service_(service)
+		, pending_(std::make_shared<PendingOperations>())
+	{
+		assert(service_ != nullptr);
+	}
+
+	template<typename byte_type>
+	AsyncFileStream<byte_type>::AsyncFileStream(AsyncFileStream&& stream)
+		: file_(std::move(stream.file_))
+		, service_(std::move(stream.service_))
+		, pending_(std::move(stream.pending_))
+		, is_close_(stream.is_close_)
+	{
+		stream.is_close_ = true;
+	}
+
+	template<typename byte_type>
+	AsyncFileStream<byte_type>& AsyncFileStream<byte_type>::operator=(AsyncFileStream&& stream)
+	{
+		close();
+
+		file_ = std::move(stream.file_);
+		service_ = std::move(stream.service_);
+		pending_ = std::move(stream.pending_);
+		is_close_ = stream.is_close_;
+
+		stream.is_close_ = true;
+
+		return *this;
+	}
+
+	template<typename byte_type>
+	AsyncFileStream<byte_type>::~AsyncFileStream()
+	{
+		try
+		{
+			close();
+		}
+		catch (...)
+		{}
+	}
+
+	template<typename byte_type>
+	AsyncFileStream<byte_type> AsyncFileStream<byte_type>::open(const std::shared_ptr<AsyncIOService>& service, const char* path, FileAccess file_access, FileMode file_mode, FileShare file_share, uint64_t flags)
+	{
+		auto file = FileStream<byte_type>::open(path, file_access, file_mode, file_share, flags);
+		return AsyncFileStream<byte_type>(std::move(file), service);
+	}
+
+	template<typename byte_type>
+	std::future<typename AsyncFileStream<byte_type>::count_type> AsyncFileStream<byte_type>::async_read(size_type offset, byte_type* buffer, count_type count)
+	{
+		auto promise = std::make_shared<std::promise<count_type>>();
+		auto future = promise->get_future();
+
+		async_read(offset, buffer, count, [promise](count_type read_bytes, std::exception_ptr error)
+		{
+			if (error)
+			{
+				promise->set_exception(error);
+			}
+			else
+			{
+				promise->set_value(read_bytes);
+			}
+		});
+
+		return future;
+	}
+
+	template<typename byte_type>
+	std::future<typename AsyncFileStream<byte_type>::count_type> AsyncFileStream<byte_type>::async_write(size_type offset, const byte_type* data, count_type count)
+	{
+		auto promise = std::make_shared<std::promise<count_type>>();
+		auto future = promise->get_future();
+
+		async_write(offset, data, count, [promise](count_type written_bytes, std::exception_ptr error)
+		{
+			if (error)
+			{
+				promise->set_exception(error);
+			}
+			else
+			{
+				promise->set_value(written_bytes);
+			}
+		});
+
+		return future;
+	}
+
+	template<typename byte_type>
+	void AsyncFileStream<byte_type>::async_read(size_type offset, byte_type* buffer, count_type count, callback_type callback)
+	{
+		CHECK_STREAM_STATE;
+		auto pending = pending_;
+		pending->acquire();
+
+		service_->read(file_.native_handle(), offset, buffer, count, [pending, callback](count_type read_bytes, std::exception_ptr error)
+		{
+			try
+			{
+				callback(read_bytes, error);
+			}
+			catch (...)
+			{
+				pending->release();
+				throw;
+			}
+
+			pending->release();
+		});
+	}
+
+	template<typename byte_type>
+	void AsyncFileStream<byte_type>::async_write(size_type offset, const byte_type* data, count_type count, callback_type callback)
+	{
+		CHECK_STREAM_STATE;
+		auto pending = pending_;
+		pending->acquire();
+
+		service_->write(file_.native_handle(), offset, data, count, [pending, callback](count_type written_bytes, std::exception_ptr error)
+		{
+			try
+			{
+				callback(written_bytes, error);
+			}
+			catch (...)
+			{
+				pending->release();
+				throw;
+			}
+
+			pending->release();
+		});
+	}
+
+	template<typename byte_type>
+	void AsyncFileStream<byte_type>::close()
+	{
+		if (!is_close_)
+		{
+			is_close_ = true;
+			service_->submit();
+			pending_->wait();
+			file_.close();
+		}
+	}
+
+	template<typename byte_type>
+	typename AsyncFileStream<byte_type>::size_type AsyncFileStream<byte_type>::size() const
+	{
+		CHECK_STREAM_STATE;
+		return file_.size();
+	}
+
+	template<typename byte_type>
+	typename AsyncFileStream<byte_type>::size_type AsyncFileStream<byte_type>::tell() const
+	{
+		CHECK_STREAM_STATE;
+		return file_.tell();
+	}
+
+	template<typename byte_type>
+	std::string AsyncFileStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		CHECK_STREAM_STATE;
+		return file_.to_string(transformer);
+	}
+
+	template<typename byte_type>
+	void AsyncFileStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		CHECK_STREAM_STATE;
+		file_.seek(off, way);
+	}
+
+	template<typename byte_type>
+	void AsyncFileStream<byte_type>::resize(size_type size)
+	{
+		CHECK_STREAM_STATE;
+		file_.resize(size);
+	}
+
+	template<typename byte_type>
+	typename AsyncFileStream<byte_type>::count_type AsyncFileStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		CHECK_STREAM_STATE;
+		return file_.read(buffer, count);
+	}
+
+	template<typename byte_type>
+	typename AsyncFileStream<byte_type>::count_type AsyncFileStream<byte_type>::write(const byte_type* data, count_type size)
+	{
+		CHECK_STREAM_STATE;
+		return file_.write(data, size);
+	}
+
+	template<typename byte_type>
+	typename AsyncFileStream<byte_type>::count_type AsyncFileStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		CHECK_STREAM_STATE;
+		return file_.pread(offset, buffer, count);
+	}
+
+	template<typename byte_type>
+	typename AsyncFileStream<byte_type>::count_type AsyncFileStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type size)
+	{
+		CHECK_STREAM_STATE;
+		return file_.pwrite(offset, data, size);
+	}
+
+	template class AsyncFileStream<uint8_t>;
+	template class AsyncFileStream<char>;
+}
+
+#endif
\ No newline at end of file
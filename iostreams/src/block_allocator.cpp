@@ -0,0 +1,204 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/block_allocator.h"
+
+#ifdef __linux__
+#include "iostreams/error.h"
+#include "liberror/exception.h"
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace iostreams
+{
+	template<typename byte_type>
+	const std::shared_ptr<HeapBlockAllocator<byte_type>>& HeapBlockAllocator<byte_type>::instance()
+	{
+		static const auto allocator = std::make_shared<HeapBlockAllocator<byte_type>>();
+		return allocator;
+	}
+
+	template<typename byte_type>
+	std::shared_ptr<byte_type> HeapBlockAllocator<byte_type>::allocate(size_t block_size)
+	{
+		return std::shared_ptr<byte_type>(new byte_type[block_size], std::default_delete<byte_type[]>());
+	}
+
+#ifdef __linux__
+	template<typename byte_type>
+	constexpr size_t HugePageBlockAllocator<byte_type>::HUGE_PAGE_SIZE;
+
+	template<typename byte_type>
+	std::shared_ptr<byte_type> HugePageBlockAllocator<byte_type>::allocate(size_t block_size)
+	{
+		auto size = (block_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		auto data = MAP_FAILED;
+
+		if (mode_ == HugePageMode::EXPLICIT)
+		{
+			data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		}
+
+		if (data == MAP_FAILED)
+		{
+			// transparent huge pages only back 2 MiB aligned ranges, so the mapping is over-allocated and trimmed
+			auto mapping = ::mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			THROW_IF(mapping == MAP_FAILED, POSIX_ERROR("mmap"));
+
+			auto address = reinterpret_cast<uintptr_t>(mapping);
+			auto aligned = (address + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+			auto tail = address + size + HUGE_PAGE_SIZE - (aligned + size);
+
+			if (aligned != address)
+			{
+				::munmap(mapping, aligned - address);
+			}
+
+			if (tail != 0)
+			{
+				::munmap(reinterpret_cast<void*>(aligned + size), tail);
+			}
+
+			data = reinterpret_cast<void*>(aligned);
+
+			// only a hint, kernels built without THP reject it
+			::madvise(data, size, MADV_HUGEPAGE);
+		}
+
+		std::shared_ptr<byte_type> block(static_cast<byte_type*>(data), [size](byte_type* block)
+		{
+			::munmap(block, size);
+		});
+
+		if (numa_node_ >= 0)
+		{
+			static constexpr size_t NODE_MASK_BITS{ sizeof(unsigned long) * 8 };
+			THROW_IF(static_cast<size_t>(numa_node_) >= NODE_MASK_BITS, IOStreamsException(errors::OUT_OF_RANGE));
+
+			// the policy applies on first touch, before that the pages are not backed yet
+			unsigned long node_mask = 1ul << numa_node_;
+			THROW_IF(::syscall(__NR_mbind, data, size, MPOL_BIND, &node_mask, NODE_MASK_BITS, 0) != 0, POSIX_ERROR("mbind"));
+		}
+
+		return block;
+	}
+
+	template class HugePageBlockAllocator<uint8_t>;
+	template class HugePageBlockAllocator<char>;
+#endif
+
+	template<typename byte_type>
+	BlockPool<byte_type>::BlockPool(size_t block_size, size_t max_free_blocks)
+		: block_size_(block_size)
+		, max_free_blocks_(max_free_blocks)
+	{
+		free_blocks_.reserve(max_free_blocks_);
+	}
+
+	template<typename byte_type>
+	BlockPool<byte_type>::~BlockPool()
+	{
+		trim();
+	}
+
+	template<typename byte_type>
+	std::shared_ptr<BlockPool<byte_type>> BlockPool<byte_type>::create(size_t block_size, size_t max_free_blocks)
+	{
+		return std::shared_ptr<BlockPool<byte_type>>(new BlockPool<byte_type>(block_size, max_free_blocks));
+	}
+
+	template<typename byte_type>
+	size_t BlockPool<byte_type>::free_blocks() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return free_blocks_.size();
+	}
+
+	template<typename byte_type>
+	std::shared_ptr<byte_type> BlockPool<byte_type>::allocate(size_t block_size)
+	{
+		if (block_size != block_size_)
+		{
+			return HeapBlockAllocator<byte_type>::instance()->allocate(block_size);
+		}
+
+		byte_type* block{ nullptr };
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			if (!free_blocks_.empty())
+			{
+				block = free_blocks_.back();
+				free_blocks_.pop_back();
+			}
+		}
+
+		if (block == nullptr)
+		{
+			block = new byte_type[block_size_];
+		}
+
+		++used_blocks_;
+		std::weak_ptr<BlockPool<byte_type>> pool = this->shared_from_this();
+
+		return std::shared_ptr<byte_type>(block, [pool](byte_type* block)
+		{
+			BlockPool<byte_type>::release(pool, block);
+		});
+	}
+
+	template<typename byte_type>
+	void BlockPool<byte_type>::trim()
+	{
+		std::vector<byte_type*> free_blocks;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			free_blocks.swap(free_blocks_);
+		}
+
+		for (auto block : free_blocks)
+		{
+			delete[] block;
+		}
+	}
+
+	// blocks may outlive their pool, they are freed directly in that case
+	template<typename byte_type>
+	void BlockPool<byte_type>::release(const std::weak_ptr<BlockPool>& pool, byte_type* block)
+	{
+		auto self = pool.lock();
+
+		if (self)
+		{
+			--self->used_blocks_;
+			std::lock_guard<std::mutex> lock(self->mutex_);
+
+			if (self->free_blocks_.size() < self->max_free_blocks_)
+			{
+				self->free_blocks_.push_back(block);
+				return;
+			}
+		}
+
+		delete[] block;
+	}
+
+	template class HeapBlockAllocator<uint8_t>;
+	template class HeapBlockAllocator<char>;
+
+	template class BlockPool<uint8_t>;
+	template class BlockPool<char>;
+}
\ No newline at end of file
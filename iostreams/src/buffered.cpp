@@ -0,0 +1,244 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/buffered.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace iostreams
+{
+	template<typename byte_type>
+	BufferedStream<byte_type>::BufferedStream(const std::shared_ptr<stream_type>& stream, count_type read_buffer_size, count_type write_buffer_size)
+		: stream_(stream)
+		, read_buffer_(read_buffer_size)
+		, write_buffer_(write_buffer_size)
+	{
+		assert(stream_ != nullptr);
+		position_ = stream_->tell();
+	}
+
+	template<typename byte_type>
+	BufferedStream<byte_type>::BufferedStream(BufferedStream&& stream)
+		: stream_(std::move(stream.stream_))
+		, position_(stream.position_)
+		, read_buffer_(std::move(stream.read_buffer_))
+		, read_begin_(stream.read_begin_)
+		, read_size_(stream.read_size_)
+		, write_buffer_(std::move(stream.write_buffer_))
+		, write_begin_(stream.write_begin_)
+		, write_size_(stream.write_size_)
+	{
+		stream.position_ = 0;
+		stream.read_size_ = 0;
+		stream.write_size_ = 0;
+	}
+
+	template<typename byte_type>
+	BufferedStream<byte_type>& BufferedStream<byte_type>::operator=(BufferedStream&& stream)
+	{
+		if (this != &stream)
+		{
+			flush();
+
+			stream_ = std::move(stream.stream_);
+			position_ = stream.position_;
+			read_buffer_ = std::move(stream.read_buffer_);
+			read_begin_ = stream.read_begin_;
+			read_size_ = stream.read_size_;
+			write_buffer_ = std::move(stream.write_buffer_);
+			write_begin_ = stream.write_begin_;
+			write_size_ = stream.write_size_;
+
+			stream.position_ = 0;
+			stream.read_size_ = 0;
+			stream.write_size_ = 0;
+		}
+
+		return *this;
+	}
+
+	template<typename byte_type>
+	BufferedStream<byte_type>::~BufferedStream()
+	{
+		try
+		{
+			flush();
+		}
+		catch (...)
+		{}
+	}
+
+	template<typename byte_type>
+	std::string BufferedStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		const_cast<BufferedStream<byte_type>*>(this)->flush();
+		return stream_->to_string(transformer);
+	}
+
+	template<typename byte_type>
+	typename BufferedStream<byte_type>::size_type BufferedStream<byte_type>::size() const
+	{
+		return std::max<size_type>(stream_->size(), write_begin_ + write_size_);
+	}
+
+	template<typename byte_type>
+	void BufferedStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		auto stream_size = size();
+
+		if (way == std::ios_base::cur)
+		{
+			off += static_cast<off_type>(position_);
+		}
+		else if (way == std::ios_base::end)
+		{
+			off += static_cast<off_type>(stream_size);
+		}
+
+		THROW_IF(off < 0 || static_cast<size_type>(off) > stream_size, IOStreamsException(errors::OUT_OF_RANGE));
+		position_ = static_cast<size_type>(off);
+
+		if (write_size_ > 0 && (position_ < write_begin_ || position_ > write_begin_ + write_size_))
+		{
+			flush();
+		}
+	}
+
+	template<typename byte_type>
+	void BufferedStream<byte_type>::resize(size_type size)
+	{
+		flush();
+		read_size_ = 0;
+		stream_->resize(size);
+
+		if (position_ > size)
+		{
+			position_ = size;
+		}
+	}
+
+	template<typename byte_type>
+	typename BufferedStream<byte_type>::count_type BufferedStream<byte_type>::write(const byte_type* data, count_type size)
+	{
+		assert(data != nullptr);
+
+		if (size == 0)
+		{
+			return 0;
+		}
+
+		read_size_ = 0;
+
+		if (write_size_ > 0 && (position_ < write_begin_ || position_ > write_begin_ + write_size_))
+		{
+			flush();
+		}
+
+		if (write_size_ == 0)
+		{
+			write_begin_ = position_;
+		}
+
+		auto offset = static_cast<count_type>(position_ - write_begin_);
+
+		if (offset + size > write_buffer_.size())
+		{
+			flush();
+
+			if (size >= write_buffer_.size())
+			{
+				auto written_bytes = stream_->pwrite(position_, data, size);
+				position_ += written_bytes;
+				return written_bytes;
+			}
+
+			write_begin_ = position_;
+			offset = 0;
+		}
+
+		std::memcpy(write_buffer_.data() + offset, data, size);
+		write_size_ = std::max(write_size_, offset + size);
+		position_ += size;
+		return size;
+	}
+
+	template<typename byte_type>
+	typename BufferedStream<byte_type>::count_type BufferedStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		assert(buffer != nullptr);
+		flush();
+
+		count_type read_bytes{ 0 };
+
+		while (count > 0)
+		{
+			if (position_ >= read_begin_ && position_ < read_begin_ + read_size_)
+			{
+				auto offset = static_cast<count_type>(position_ - read_begin_);
+				auto processed = std::min(count, read_size_ - offset);
+				std::memcpy(buffer, read_buffer_.data() + offset, processed);
+				buffer += processed;
+				count -= processed;
+				read_bytes += processed;
+				position_ += processed;
+			}
+			else if (count >= read_buffer_.size())
+			{
+				auto bytes = stream_->pread(position_, buffer, count);
+				read_bytes += bytes;
+				position_ += bytes;
+				break;
+			}
+			else
+			{
+				read_begin_ = position_;
+				read_size_ = stream_->pread(position_, read_buffer_.data(), read_buffer_.size());
+
+				if (read_size_ == 0)
+				{
+					break;
+				}
+			}
+		}
+
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename BufferedStream<byte_type>::count_type BufferedStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		const_cast<BufferedStream<byte_type>*>(this)->flush();
+		return stream_->pread(offset, buffer, count);
+	}
+
+	template<typename byte_type>
+	typename BufferedStream<byte_type>::count_type BufferedStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type size)
+	{
+		flush();
+		read_size_ = 0;
+		return stream_->pwrite(offset, data, size);
+	}
+
+	template<typename byte_type>
+	void BufferedStream<byte_type>::flush()
+	{
+		if (write_size_ > 0)
+		{
+			auto written_bytes = stream_->pwrite(write_begin_, write_buffer_.data(), write_size_);
+			THROW_IF(written_bytes != write_size_, IOStreamsException(errors::INCOMPLETE_WRITE));
+			write_size_ = 0;
+		}
+	}
+
+	template class BufferedStream<uint8_t>;
+	template class BufferedStream<char>;
+}
\ No newline at end of file
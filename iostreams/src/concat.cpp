@@ -0,0 +1,155 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/concat.h"
+#include <algorithm>
+#include <cassert>
+
+namespace iostreams
+{
+	template<typename byte_type>
+	ConcatStream<byte_type>::ConcatStream(std::vector<std::shared_ptr<stream_type>> streams)
+		: streams_(std::move(streams))
+	{
+		refresh();
+	}
+
+	template<typename byte_type>
+	void ConcatStream<byte_type>::append(const std::shared_ptr<stream_type>& stream)
+	{
+		assert(stream != nullptr);
+		streams_.push_back(stream);
+		offsets_.push_back(offsets_.back() + stream->size());
+	}
+
+	template<typename byte_type>
+	void ConcatStream<byte_type>::refresh()
+	{
+		offsets_.resize(1);
+		offsets_.reserve(streams_.size() + 1);
+
+		for (const auto& stream : streams_)
+		{
+			assert(stream != nullptr);
+			offsets_.push_back(offsets_.back() + stream->size());
+		}
+
+		position_ = std::min(position_, offsets_.back());
+	}
+
+	template<typename byte_type>
+	std::string ConcatStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		static constexpr size_type CHUNK_SIZE{ 64 * 1024 };
+		std::string result;
+		auto stream_size = size();
+
+		if (stream_size > 0)
+		{
+			THROW_IF(stream_size > result.max_size(), IOStreamsException(errors::STREAM_SIZE_TOO_BIG));
+			result.reserve(transformer.required_size(static_cast<count_type>(stream_size)));
+
+			std::vector<byte_type> buffer(static_cast<size_t>(std::min(stream_size, CHUNK_SIZE)));
+			size_type offset{ 0 };
+			count_type read_bytes{ 0 };
+
+			while ((read_bytes = pread(offset, buffer.data(), buffer.size())) > 0)
+			{
+				transform_to_string(transformer, buffer.data(), read_bytes, result);
+
+				offset += read_bytes;
+			}
+
+			finish_to_string(transformer, result);
+		}
+
+		return result;
+	}
+
+	template<typename byte_type>
+	void ConcatStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		if (way == std::ios_base::cur)
+		{
+			off += static_cast<off_type>(position_);
+		}
+		else if (way == std::ios_base::end)
+		{
+			off += static_cast<off_type>(size());
+		}
+
+		THROW_IF(off < 0 || static_cast<size_type>(off) > size(), IOStreamsException(errors::OUT_OF_RANGE));
+		position_ = static_cast<size_type>(off);
+	}
+
+	template<typename byte_type>
+	void ConcatStream<byte_type>::resize(size_type)
+	{
+		throw IOStreamsException(errors::STREAM_READ_ONLY);
+	}
+
+	template<typename byte_type>
+	typename ConcatStream<byte_type>::count_type ConcatStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		auto read_bytes = pread(position_, buffer, count);
+		position_ += read_bytes;
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename ConcatStream<byte_type>::count_type ConcatStream<byte_type>::write(const byte_type*, count_type)
+	{
+		throw IOStreamsException(errors::STREAM_READ_ONLY);
+	}
+
+	template<typename byte_type>
+	typename ConcatStream<byte_type>::count_type ConcatStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		assert(buffer != nullptr);
+
+		if (offset >= size())
+		{
+			return 0;
+		}
+
+		// the last part starting at or before the offset, which skips empty parts
+		auto index = static_cast<size_t>(std::upper_bound(offsets_.begin(), offsets_.end(), offset) - offsets_.begin() - 1);
+		count_type read_bytes{ 0 };
+
+		while (read_bytes < count && index < streams_.size())
+		{
+			auto relative_offset = offset - offsets_[index];
+			auto part_bytes = static_cast<count_type>(std::min<size_type>(count - read_bytes, offsets_[index + 1] - offsets_[index] - relative_offset));
+			auto bytes = streams_[index]->pread(relative_offset, buffer + read_bytes, part_bytes);
+			read_bytes += bytes;
+			offset += bytes;
+
+			if (bytes < part_bytes)
+			{
+				// the part shrank since the index was built
+				break;
+			}
+
+			++index;
+		}
+
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename ConcatStream<byte_type>::count_type ConcatStream<byte_type>::pwrite(size_type, const byte_type*, count_type)
+	{
+		throw IOStreamsException(errors::STREAM_READ_ONLY);
+	}
+
+	template class ConcatStream<uint8_t>;
+	template class ConcatStream<char>;
+}
\ No newline at end of file
@@ -77,6 +77,19 @@ iostreams::FileStream<byte_type> iostreams::FileStream<byte_type>::open(const ch
 	return FileStream<byte_type>(FileImpl::open(path, file_access, file_mode, file_share, flags), path, file_access, file_mode, file_share);
 }
 
+template<typename byte_type>
+iostreams::FileStream<byte_type> iostreams::FileStream<byte_type>::temporary(const char* directory)
+{
+	return FileStream<byte_type>(FileImpl::temporary(directory), "", FileAccess::READ_WRITE, FileMode::F_CREATE_NEW, FileShare::NONE);
+}
+
+template<typename byte_type>
+typename iostreams::FileStream<byte_type>::native_handle_type iostreams::FileStream<byte_type>::native_handle() const
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->native_handle();
+}
+
 template<typename byte_type>
 bool iostreams::FileStream<byte_type>::auto_flush() const
 {
@@ -91,13 +104,91 @@ void iostreams::FileStream<byte_type>::set_auto_flush(bool val)
 	return pimpl_->set_auto_flush(val);
 }
 
+template<typename byte_type>
+iostreams::FlushPolicy iostreams::FileStream<byte_type>::flush_policy() const
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->flush_policy();
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::set_flush_policy(const FlushPolicy& policy)
+{
+	CHECK_STREAM_STATE;
+	pimpl_->set_flush_policy(policy);
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::flush()
+{
+	CHECK_STREAM_STATE;
+	pimpl_->flush();
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::sync()
+{
+	CHECK_STREAM_STATE;
+	pimpl_->sync();
+}
+
+template<typename byte_type>
+bool iostreams::FileStream<byte_type>::cache_state() const
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->cache_state();
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::set_cache_state(bool val)
+{
+	CHECK_STREAM_STATE;
+	pimpl_->set_cache_state(val);
+}
+
+template<typename byte_type>
+bool iostreams::FileStream<byte_type>::direct_io() const
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->direct_io();
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::set_direct_io(bool val)
+{
+	CHECK_STREAM_STATE;
+	pimpl_->set_direct_io(val);
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::advise(FileAccessPattern pattern, size_type offset, size_type length)
+{
+	CHECK_STREAM_STATE;
+	pimpl_->advise(pattern, offset, length);
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::reserve(size_type size)
+{
+	CHECK_STREAM_STATE;
+	pimpl_->reserve(size);
+}
+
+template<typename byte_type>
+void iostreams::FileStream<byte_type>::refresh()
+{
+	CHECK_STREAM_STATE;
+	pimpl_->refresh();
+}
+
 template<typename byte_type>
 void iostreams::FileStream<byte_type>::close()
 {
 	if (pimpl_)
 	{
-		pimpl_->close();
-		pimpl_ = nullptr;
+		// the handle is gone even when the final sync throws
+		auto pimpl = std::move(pimpl_);
+		pimpl->close();
 	}
 }
 
@@ -127,16 +218,10 @@ std::string iostreams::FileStream<byte_type>::to_string(IToStringTransform<byte_
 		while (i-- > 0)
 		{
 			bytes_read = self->read(buffer.data(), buffer.size());
-			transformer.update(buffer.data(), bytes_read, [&result](const char* data, count_type size)
-			{
-				result.insert(result.end(), data, data + size);
-			});
+			transform_to_string(transformer, buffer.data(), bytes_read, result);
 		}
 
-		transformer.update_final([&result](const char* data, count_type size)
-		{
-			result.insert(result.end(), data, data + size);
-		});
+		finish_to_string(transformer, result);
 
 		self->seek(current_position);
 	}
@@ -187,7 +272,35 @@ typename iostreams::FileStream<byte_type>::count_type iostreams::FileStream<byte
 }
 
 template<typename byte_type>
-void iostreams::FileStream<byte_type>::check_seek_range(off_type off, std::ios_base::seekdir way, size_type current_position, size_type size)
+typename iostreams::FileStream<byte_type>::count_type iostreams::FileStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->pread(offset, buffer, count);
+}
+
+template<typename byte_type>
+typename iostreams::FileStream<byte_type>::count_type iostreams::FileStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type size)
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->pwrite(offset, data, size);
+}
+
+template<typename byte_type>
+typename iostreams::FileStream<byte_type>::count_type iostreams::FileStream<byte_type>::readv(const Buffer* buffers, count_type count)
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->readv(buffers, count);
+}
+
+template<typename byte_type>
+typename iostreams::FileStream<byte_type>::count_type iostreams::FileStream<byte_type>::writev(const ConstBuffer* buffers, count_type count)
+{
+	CHECK_STREAM_STATE;
+	return pimpl_->writev(buffers, count);
+}
+
+template<typename byte_type>
+typename iostreams::FileStream<byte_type>::size_type iostreams::FileStream<byte_type>::check_seek_range(off_type off, std::ios_base::seekdir way, size_type current_position, size_type size)
 {
 	if (way == std::ios_base::cur)
 	{
@@ -199,6 +312,7 @@ void iostreams::FileStream<byte_type>::check_seek_range(off_type off, std::ios_b
 	}
 
 	THROW_IF(off < 0 || static_cast<size_type>(off) > size, IOStreamsException(errors::OUT_OF_RANGE));
+	return static_cast<size_type>(off);
 }
 
 template class iostreams::FileStream<uint8_t>;
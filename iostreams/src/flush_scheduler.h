@@ -0,0 +1,197 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_FLUSH_SCHEDULER_H_
+#define _IOSTREAMS_FLUSH_SCHEDULER_H_
+
+#include "iostreams/file.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace iostreams
+{
+	// Group commit for FileImpl: counts written bytes and calls the platform data sync once per byte
+	// threshold or time window, either inline on the writing thread or from a background flusher.
+	// A failure of the background flusher is rethrown by the next write or flush.
+	class FlushScheduler
+	{
+	private:
+		using clock_type = std::chrono::steady_clock;
+
+		std::function<void()> data_sync_;
+		FlushPolicy policy_;
+		std::atomic<uint64_t> pending_bytes_{ 0 };
+		clock_type::time_point last_flush_{ clock_type::now() };
+
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		std::exception_ptr error_;
+		std::atomic<bool> failed_{ false };
+		bool stop_{ false };
+		std::thread thread_;
+
+	public:
+		explicit FlushScheduler(std::function<void()> data_sync)
+			: data_sync_(std::move(data_sync))
+		{}
+
+		FlushScheduler(const FlushScheduler&) = delete;
+		FlushScheduler& operator=(const FlushScheduler&) = delete;
+
+		~FlushScheduler()
+		{
+			stop();
+		}
+
+		const FlushPolicy& policy() const { return policy_; }
+
+		void set_policy(const FlushPolicy& policy)
+		{
+			stop();
+			policy_ = policy;
+
+			if (policy_.background && policy_.interval.count() > 0)
+			{
+				stop_ = false;
+				thread_ = std::thread(&FlushScheduler::run, this);
+			}
+		}
+
+		void on_write(uint64_t bytes)
+		{
+			// the bytes are on their way to the disk even when a previous sync failed
+			auto pending_bytes = pending_bytes_ += bytes;
+			rethrow_error();
+
+			if (policy_.bytes_threshold != 0 && pending_bytes >= policy_.bytes_threshold)
+			{
+				flush();
+			}
+			else if (!thread_.joinable() && policy_.interval.count() > 0 && clock_type::now() - last_flush_ >= policy_.interval)
+			{
+				flush();
+			}
+		}
+
+		// a barrier: everything written before the call is durable when it returns
+		void flush()
+		{
+			flush(data_sync_);
+		}
+
+		// for callers that sync by other means, e.g. fsync; the written bytes stay pending if it throws
+		void flush(const std::function<void()>& sync)
+		{
+			rethrow_error();
+			auto pending_bytes = pending_bytes_.load();
+			sync();
+			consume(pending_bytes);
+			last_flush_ = clock_type::now();
+		}
+
+		// stops the background flusher and returns the number of bytes written since the last sync
+		uint64_t shutdown()
+		{
+			stop();
+			rethrow_error();
+			return pending_bytes_.exchange(0);
+		}
+
+	private:
+		void run()
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+
+			while (!cv_.wait_for(lock, policy_.interval, [this]() { return stop_; }))
+			{
+				auto pending_bytes = pending_bytes_.load();
+
+				if (pending_bytes != 0)
+				{
+					// writers only take the mutex to collect an error, so they never wait out the sync
+					lock.unlock();
+					std::exception_ptr error;
+
+					try
+					{
+						data_sync_();
+					}
+					catch (...)
+					{
+						error = std::current_exception();
+					}
+
+					lock.lock();
+
+					if (error)
+					{
+						error_ = error;
+						failed_ = true;
+					}
+					else
+					{
+						consume(pending_bytes);
+					}
+				}
+			}
+		}
+
+		void stop()
+		{
+			if (thread_.joinable())
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					stop_ = true;
+				}
+
+				cv_.notify_all();
+				thread_.join();
+			}
+		}
+
+		// only the bytes a successful sync covered; a concurrent flush may have consumed them already
+		void consume(uint64_t bytes)
+		{
+			auto pending_bytes = pending_bytes_.load();
+
+			while (!pending_bytes_.compare_exchange_weak(pending_bytes, pending_bytes > bytes ? pending_bytes - bytes : 0))
+			{}
+		}
+
+		void rethrow_error()
+		{
+			if (!failed_)
+			{
+				return;
+			}
+
+			std::exception_ptr error;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				std::swap(error, error_);
+				failed_ = false;
+			}
+
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+	};
+}
+
+#endif
\ No newline at end of file
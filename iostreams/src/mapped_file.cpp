@@ -0,0 +1,337 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined (__linux__) || defined (__APPLE__)
+
+#include "iostreams/mapped_file.h"
+#include "iostreams/error.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __MACH__
+	#define ftruncate64 ftruncate
+#endif
+
+#define CHECK_STREAM_STATE if (is_close_) throw IOStreamsException(errors::STREAM_CLOSE)
+
+namespace iostreams
+{
+	template<typename byte_type>
+	MappedFileStream<byte_type>::MappedFileStream(FileStream<byte_type>&& file, bool writable)
+		: file_(std::move(file))
+		, writable_(writable)
+	{
+		size_ = file_.size();
+		remap(size_);
+	}
+
+	template<typename byte_type>
+	MappedFileStream<byte_type>::MappedFileStream(MappedFileStream&& stream)
+		: file_(std::move(stream.file_))
+		, data_(stream.data_)
+		, size_(stream.size_)
+		, capacity_(stream.capacity_)
+		, position_(stream.position_)
+		, writable_(stream.writable_)
+		, is_close_(stream.is_close_)
+	{
+		stream.data_ = nullptr;
+		stream.size_ = 0;
+		stream.capacity_ = 0;
+		stream.position_ = 0;
+		stream.is_close_ = true;
+	}
+
+	template<typename byte_type>
+	MappedFileStream<byte_type>& MappedFileStream<byte_type>::operator=(MappedFileStream&& stream)
+	{
+		close();
+
+		file_ = std::move(stream.file_);
+		data_ = stream.data_;
+		size_ = stream.size_;
+		capacity_ = stream.capacity_;
+		position_ = stream.position_;
+		writable_ = stream.writable_;
+		is_close_ = stream.is_close_;
+
+		stream.data_ = nullptr;
+		stream.size_ = 0;
+		stream.capacity_ = 0;
+		stream.position_ = 0;
+		stream.is_close_ = true;
+
+		return *this;
+	}
+
+	template<typename byte_type>
+	MappedFileStream<byte_type>::~MappedFileStream()
+	{
+		try
+		{
+			close();
+		}
+		catch (...)
+		{}
+	}
+
+	template<typename byte_type>
+	MappedFileStream<byte_type> MappedFileStream<byte_type>::open(const char* path, FileAccess file_access, FileMode file_mode, FileShare file_share, uint64_t flags)
+	{
+		auto writable = file_access == FileAccess::WRITE || file_access == FileAccess::READ_WRITE;
+		auto file = FileStream<byte_type>::open(path, writable ? FileAccess::READ_WRITE : file_access, file_mode, file_share, flags);
+		return MappedFileStream<byte_type>(std::move(file), writable);
+	}
+
+	template<typename byte_type>
+	const byte_type* MappedFileStream<byte_type>::view(size_type offset, count_type count) const
+	{
+		CHECK_STREAM_STATE;
+		THROW_IF(offset > size_ || count > size_ - offset, IOStreamsException(errors::OUT_OF_RANGE));
+		return data_ + offset;
+	}
+
+	template<typename byte_type>
+	void MappedFileStream<byte_type>::flush()
+	{
+		CHECK_STREAM_STATE;
+
+		if (data_ != nullptr && writable_)
+		{
+			// drops the growth reserve so the file on disk has its logical size, the next write grows it again
+			if (capacity_ > size_)
+			{
+				remap(size_);
+			}
+
+			if (data_ != nullptr)
+			{
+				THROW_IF(::msync(data_, static_cast<size_t>(capacity_), MS_SYNC) != 0, POSIX_ERROR("msync"));
+			}
+		}
+	}
+
+	template<typename byte_type>
+	void MappedFileStream<byte_type>::close()
+	{
+		if (!is_close_)
+		{
+			is_close_ = true;
+			unmap();
+
+			if (writable_)
+			{
+				THROW_IF(::ftruncate64(file_.native_handle(), size_) != 0, POSIX_ERROR("ftruncate64"));
+			}
+
+			file_.close();
+		}
+	}
+
+	template<typename byte_type>
+	std::string MappedFileStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		CHECK_STREAM_STATE;
+		std::string result;
+
+		if (size_ > 0)
+		{
+			THROW_IF(size_ > result.max_size(), IOStreamsException(errors::STREAM_SIZE_TOO_BIG));
+			result.reserve(transformer.required_size(static_cast<count_type>(size_)));
+
+			transform_to_string(transformer, data_, static_cast<count_type>(size_), result);
+
+			finish_to_string(transformer, result);
+		}
+
+		return result;
+	}
+
+	template<typename byte_type>
+	typename MappedFileStream<byte_type>::size_type MappedFileStream<byte_type>::size() const
+	{
+		CHECK_STREAM_STATE;
+		return size_;
+	}
+
+	template<typename byte_type>
+	typename MappedFileStream<byte_type>::size_type MappedFileStream<byte_type>::tell() const
+	{
+		CHECK_STREAM_STATE;
+		return position_;
+	}
+
+	template<typename byte_type>
+	void MappedFileStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		CHECK_STREAM_STATE;
+
+		if (way == std::ios_base::cur)
+		{
+			off += static_cast<off_type>(position_);
+		}
+		else if (way == std::ios_base::end)
+		{
+			off += static_cast<off_type>(size_);
+		}
+
+		THROW_IF(off < 0 || static_cast<size_type>(off) > size_, IOStreamsException(errors::OUT_OF_RANGE));
+		position_ = static_cast<size_type>(off);
+	}
+
+	template<typename byte_type>
+	void MappedFileStream<byte_type>::reserve(size_type count)
+	{
+		CHECK_STREAM_STATE;
+		THROW_IF(!writable_, IOStreamsException(errors::STREAM_READ_ONLY));
+
+		if (capacity_ < count)
+		{
+			static const size_type page_size = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+			auto new_capacity = std::max<size_type>(count, capacity_ * 2);
+			remap((new_capacity + page_size - 1) / page_size * page_size);
+		}
+	}
+
+	template<typename byte_type>
+	void MappedFileStream<byte_type>::resize(size_type new_size)
+	{
+		CHECK_STREAM_STATE;
+		THROW_IF(!writable_, IOStreamsException(errors::STREAM_READ_ONLY));
+
+		if (new_size > size_)
+		{
+			reserve(new_size);
+			std::memset(data_ + size_, 0, static_cast<size_t>(new_size - size_));
+		}
+
+		size_ = new_size;
+
+		if (position_ > size_)
+		{
+			position_ = size_;
+		}
+	}
+
+	template<typename byte_type>
+	typename MappedFileStream<byte_type>::count_type MappedFileStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		auto read_bytes = pread(position_, buffer, count);
+		position_ += read_bytes;
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename MappedFileStream<byte_type>::count_type MappedFileStream<byte_type>::write(const byte_type* data, count_type count)
+	{
+		auto written_bytes = pwrite(position_, data, count);
+		position_ += written_bytes;
+		return written_bytes;
+	}
+
+	template<typename byte_type>
+	typename MappedFileStream<byte_type>::count_type MappedFileStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		assert(buffer != nullptr);
+		CHECK_STREAM_STATE;
+
+		count_type read_bytes{ 0 };
+
+		if (offset < size_)
+		{
+			read_bytes = static_cast<count_type>(std::min<size_type>(count, size_ - offset));
+			std::memcpy(buffer, data_ + offset, read_bytes);
+		}
+
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename MappedFileStream<byte_type>::count_type MappedFileStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type count)
+	{
+		assert(data != nullptr);
+		CHECK_STREAM_STATE;
+		THROW_IF(!writable_, IOStreamsException(errors::STREAM_READ_ONLY));
+
+		if (count > 0)
+		{
+			if (offset > size_)
+			{
+				resize(offset);
+			}
+
+			reserve(offset + count);
+			std::memcpy(data_ + offset, data, count);
+
+			if (offset + count > size_)
+			{
+				size_ = offset + count;
+			}
+		}
+
+		return count;
+	}
+
+	template<typename byte_type>
+	void MappedFileStream<byte_type>::unmap()
+	{
+		if (data_ != nullptr)
+		{
+			::munmap(data_, static_cast<size_t>(capacity_));
+			data_ = nullptr;
+		}
+
+		capacity_ = 0;
+	}
+
+	template<typename byte_type>
+	void MappedFileStream<byte_type>::remap(size_type new_capacity)
+	{
+		auto fd = file_.native_handle();
+
+		if (writable_)
+		{
+			THROW_IF(::ftruncate64(fd, new_capacity) != 0, POSIX_ERROR("ftruncate64"));
+		}
+
+#ifdef __linux__
+		if (data_ != nullptr && new_capacity > 0)
+		{
+			auto data = ::mremap(data_, static_cast<size_t>(capacity_), static_cast<size_t>(new_capacity), MREMAP_MAYMOVE);
+			THROW_IF(data == MAP_FAILED, POSIX_ERROR("mremap"));
+
+			data_ = static_cast<byte_type*>(data);
+			capacity_ = new_capacity;
+			return;
+		}
+#endif
+
+		unmap();
+
+		if (new_capacity > 0)
+		{
+			auto protection = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+			auto data = ::mmap(nullptr, static_cast<size_t>(new_capacity), protection, MAP_SHARED, fd, 0);
+			THROW_IF(data == MAP_FAILED, POSIX_ERROR("mmap"));
+
+			data_ = static_cast<byte_type*>(data);
+			capacity_ = new_capacity;
+		}
+	}
+
+	template class MappedFileStream<uint8_t>;
+	template class MappedFileStream<char>;
+}
+
+#endif
\ No newline at end of file
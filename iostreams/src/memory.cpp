@@ -13,9 +13,45 @@
 #include "iostreams/error.h"
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace iostreams
 {
+	template<typename byte_type>
+	constexpr typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::DEFAULT_BLOCK_SIZE;
+
+	template<typename byte_type>
+	MemoryStream<byte_type> MemoryStream<byte_type>::adopt(byte_type* data, size_type size, std::function<void(byte_type*)> deleter)
+	{
+		MemoryStream<byte_type> stream(static_cast<count_type>(size));
+
+		if (!deleter)
+		{
+			deleter = [](byte_type*) {};
+		}
+
+		if (size > 0)
+		{
+			stream.blocks_.push_back(std::shared_ptr<byte_type>(data, std::move(deleter)));
+			stream.size_ = size;
+			stream.capacity_ = size;
+		}
+		else if (data != nullptr)
+		{
+			deleter(data);
+		}
+
+		return stream;
+	}
+
+	template<typename byte_type>
+	MemoryStream<byte_type> MemoryStream<byte_type>::snapshot() const
+	{
+		MemoryStream<byte_type> stream(*this);
+		stream.set_position(0);
+		return stream;
+	}
+
 	template<typename byte_type>
 	MemoryStream<byte_type> MemoryStream<byte_type>::create(const std::string& str, IFromStringTransform<byte_type>& transformer)
 	{
@@ -51,30 +87,15 @@ namespace iostreams
 			}
 
 			result.reserve(transformer.required_size(static_cast<count_type>(stream_size)));
-			size_type read_bytes{ 0 };
 
-			for (auto i = 0u; i < blocks_.size() - 1; ++i)
+			for (size_type offset = 0; offset < stream_size; offset += block_size_)
 			{
-				const auto& block = blocks_[i];
-				read_bytes += block.size();
+				const auto& block = blocks_[static_cast<count_type>(offset / block_size_)];
 
-				transformer.update(block.data(), block.size(), [&result](const char* data, count_type size)
-				{
-					result.insert(result.end(), data, data + size);
-				});
+				transform_to_string(transformer, block.get(), static_cast<count_type>(std::min<size_type>(block_size_, stream_size - offset)), result);
 			}
 
-			const auto& block = blocks_.back();
-
-			transformer.update(block.data(), static_cast<count_type>(stream_size - read_bytes), [&result](const char* data, count_type size)
-			{
-				result.insert(result.end(), data, data + size);
-			});
-
-			transformer.update_final([&result](const char* data, count_type size)
-			{
-				result.insert(result.end(), data, data + size);
-			});
+			finish_to_string(transformer, result);
 		}
 
 		return result;
@@ -110,7 +131,7 @@ namespace iostreams
 
 			while (required_blocks > 0)
 			{
-				blocks_.push_back(std::vector<byte_type>(block_size_));
+				blocks_.push_back(allocator_->allocate(block_size_));
 				--required_blocks;
 			}
 
@@ -124,30 +145,27 @@ namespace iostreams
 		if (size_ > new_size)
 		{
 			auto required_blocks = static_cast<count_type>(new_size / block_size_ + (new_size % block_size_ == 0 ? 0 : 1));
+			blocks_.resize(required_blocks);
+			capacity_ = static_cast<size_type>(required_blocks) * block_size_;
 
-			if (new_size == 0)
+			if (current_position() > new_size)
 			{
-				block_index_ = 0;
-				relative_position_ = 0;
-				capacity_ = 0;
+				set_position(new_size);
 			}
-			else
-			{
-				auto position = current_position();
-
-				if (position >= new_size)
-				{
-					block_index_ = required_blocks - 1;
-					relative_position_ = block_size_ - 1;
-					capacity_ = block_size_ * required_blocks;
-				}
-			}
-
-			blocks_.resize(required_blocks);
 		}
-		else
+		else if (size_ < new_size)
 		{
 			reserve(new_size);
+
+			// blocks are not zero-initialized and a previous shrink may have left old data behind
+			for (auto offset = size_; offset < new_size;)
+			{
+				auto block_index = static_cast<count_type>(offset / block_size_);
+				auto relative_position = static_cast<count_type>(offset % block_size_);
+				auto count = static_cast<count_type>(std::min<size_type>(block_size_ - relative_position, new_size - offset));
+				std::memset(writable_block(block_index) + relative_position, 0, count);
+				offset += count;
+			}
 		}
 
 		size_ = new_size;
@@ -155,30 +173,43 @@ namespace iostreams
 
 	template<typename byte_type>
 	typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		auto position = current_position();
+		auto read_bytes = pread(position, buffer, count);
+		set_position(position + read_bytes);
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::write(const byte_type* data, count_type count)
+	{
+		auto position = current_position();
+		auto written_bytes = pwrite(position, data, count);
+		set_position(position + written_bytes);
+		return written_bytes;
+	}
+
+	template<typename byte_type>
+	typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
 	{
 		assert(buffer != nullptr);
 		count_type read_bytes{ 0 };
-		auto position = current_position();
 
-		if (size_ > 0 && position < size_)
+		if (offset < size_)
 		{
-			count = static_cast<count_type>(std::min<count_type>(count, static_cast<count_type>(size_ - position)));
+			count = static_cast<count_type>(std::min<size_type>(count, size_ - offset));
+			auto block_index = static_cast<count_type>(offset / block_size_);
+			auto relative_position = static_cast<count_type>(offset % block_size_);
 
-			while (count)
+			while (count > 0)
 			{
-				assert(relative_position_ <= block_size_);
-				auto proccesed = std::min<count_type>(count, block_size_ - relative_position_);
-				std::memcpy(buffer, blocks_[block_index_].data() + relative_position_, proccesed);
+				auto proccesed = std::min<count_type>(count, block_size_ - relative_position);
+				std::memcpy(buffer, blocks_[block_index].get() + relative_position, proccesed);
 				buffer += proccesed;
 				count -= proccesed;
 				read_bytes += proccesed;
-				relative_position_ += proccesed;
-
-				if (relative_position_ >= block_size_)
-				{
-					relative_position_ = 0;
-					++block_index_;
-				}
+				relative_position = 0;
+				++block_index;
 			}
 		}
 
@@ -186,43 +217,194 @@ namespace iostreams
 	}
 
 	template<typename byte_type>
-	typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::write(const byte_type* data, count_type count)
+	typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type count)
 	{
 		assert(data != nullptr);
 		count_type written_bytes{ 0 };
 
 		if (count > 0)
 		{
-			reserve(count + current_position());
+			if (offset > size_)
+			{
+				resize(offset);
+			}
+
+			reserve(offset + count);
+			auto block_index = static_cast<count_type>(offset / block_size_);
+			auto relative_position = static_cast<count_type>(offset % block_size_);
 
 			while (count > 0)
 			{
-				assert(relative_position_ <= block_size_);
-				auto proccesed = std::min<count_type>(count, block_size_ - relative_position_);
-				std::copy(data, data + proccesed, blocks_[block_index_].begin() + relative_position_);
+				auto proccesed = std::min<count_type>(count, block_size_ - relative_position);
+				std::memcpy(writable_block(block_index) + relative_position, data, proccesed);
 				data += proccesed;
 				count -= proccesed;
-				relative_position_ += proccesed;
 				written_bytes += proccesed;
+				relative_position = 0;
+				++block_index;
+			}
 
-				if (relative_position_ >= block_size_)
-				{
-					relative_position_ = 0;
-					++block_index_;
-				}
+			if (offset + written_bytes > size_)
+			{
+				size_ = offset + written_bytes;
 			}
+		}
 
-			auto position = current_position();
+		return written_bytes;
+	}
 
-			if (position > size_)
+	template<typename byte_type>
+	typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::readv(const Buffer* buffers, count_type count)
+	{
+		auto position = current_position();
+		count_type read_bytes{ 0 };
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			auto bytes = pread(position + read_bytes, buffers[i].data, buffers[i].size);
+			read_bytes += bytes;
+
+			if (bytes < buffers[i].size)
 			{
-				size_ = position;
+				break;
 			}
 		}
 
+		set_position(position + read_bytes);
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename MemoryStream<byte_type>::count_type MemoryStream<byte_type>::writev(const ConstBuffer* buffers, count_type count)
+	{
+		auto position = current_position();
+		count_type total{ 0 };
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			total += buffers[i].size;
+		}
+
+		reserve(position + total);
+		count_type written_bytes{ 0 };
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			written_bytes += pwrite(position + written_bytes, buffers[i].data, buffers[i].size);
+		}
+
+		set_position(position + written_bytes);
 		return written_bytes;
 	}
 
+	template<typename byte_type>
+	typename MemoryStream<byte_type>::size_type MemoryStream<byte_type>::write_to(IStream<byte_type>* stream) const
+	{
+		return write_to(stream, 0, size_);
+	}
+
+	template<typename byte_type>
+	typename MemoryStream<byte_type>::size_type MemoryStream<byte_type>::write_to(IStream<byte_type>* stream, size_type offset, size_type count) const
+	{
+		assert(stream != nullptr);
+		auto buffers = blocks(offset, count);
+		return !buffers.empty() ? stream->writev(buffers.data(), buffers.size()) : 0;
+	}
+
+	template<typename byte_type>
+	typename MemoryStream<byte_type>::size_type MemoryStream<byte_type>::read_from(IStream<byte_type>* stream, size_type count)
+	{
+		assert(stream != nullptr);
+		auto position = current_position();
+		auto buffers = writable_blocks(position, count);
+		auto read_bytes = !buffers.empty() ? stream->readv(buffers.data(), buffers.size()) : 0;
+
+		if (position + read_bytes > size_)
+		{
+			size_ = position + read_bytes;
+		}
+
+		set_position(position + read_bytes);
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	std::vector<typename MemoryStream<byte_type>::ConstBuffer> MemoryStream<byte_type>::blocks(size_type offset, size_type count) const
+	{
+		std::vector<ConstBuffer> buffers;
+
+		if (offset >= size_)
+		{
+			return buffers;
+		}
+
+		count = std::min<size_type>(count, size_ - offset);
+		auto block_index = static_cast<count_type>(offset / block_size_);
+		auto relative_position = static_cast<count_type>(offset % block_size_);
+		buffers.reserve(static_cast<size_t>((relative_position + count) / block_size_ + 1));
+
+		while (count > 0)
+		{
+			auto block_size = static_cast<count_type>(std::min<size_type>(count, block_size_ - relative_position));
+			buffers.push_back({ blocks_[block_index].get() + relative_position, block_size });
+			count -= block_size;
+			relative_position = 0;
+			++block_index;
+		}
+
+		return buffers;
+	}
+
+	template<typename byte_type>
+	std::vector<typename MemoryStream<byte_type>::Buffer> MemoryStream<byte_type>::prepare(size_type count)
+	{
+		return writable_blocks(size_, count);
+	}
+
+	template<typename byte_type>
+	void MemoryStream<byte_type>::commit(size_type count)
+	{
+		THROW_IF(size_ + count > capacity_, IOStreamsException(errors::OUT_OF_RANGE));
+		size_ += count;
+	}
+
+	template<typename byte_type>
+	std::vector<typename MemoryStream<byte_type>::Buffer> MemoryStream<byte_type>::writable_blocks(size_type offset, size_type count)
+	{
+		reserve(offset + count);
+
+		auto block_index = static_cast<count_type>(offset / block_size_);
+		auto relative_position = static_cast<count_type>(offset % block_size_);
+		std::vector<Buffer> buffers;
+		buffers.reserve(static_cast<size_t>((relative_position + count) / block_size_ + 1));
+
+		while (count > 0)
+		{
+			auto block_size = static_cast<count_type>(std::min<size_type>(count, block_size_ - relative_position));
+			buffers.push_back({ writable_block(block_index) + relative_position, block_size });
+			count -= block_size;
+			relative_position = 0;
+			++block_index;
+		}
+
+		return buffers;
+	}
+
+	template<typename byte_type>
+	byte_type* MemoryStream<byte_type>::writable_block(count_type index)
+	{
+		auto& block = blocks_[index];
+
+		if (block.use_count() > 1)
+		{
+			auto copy = allocator_->allocate(block_size_);
+			std::memcpy(copy.get(), block.get(), block_size_);
+			block = std::move(copy);
+		}
+
+		return block.get();
+	}
+
 	template class MemoryStream<uint8_t>;
 	template class MemoryStream<char>;
 }
\ No newline at end of file
@@ -0,0 +1,339 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/pipe.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#define CHECK_STREAM_STATE if (state_ == nullptr) throw IOStreamsException(errors::STREAM_CLOSE)
+
+namespace iostreams
+{
+	template<typename byte_type>
+	struct PipeStream<byte_type>::State
+	{
+		static constexpr size_t CACHE_LINE_SIZE{ 64 };
+
+		std::unique_ptr<byte_type[]> ring;
+		count_type capacity;
+
+		// the positions only grow, the ring index is position & (capacity - 1);
+		// padding keeps the producer and the consumer counters on separate cache lines
+		char padding0[CACHE_LINE_SIZE];
+		std::atomic<uint64_t> write_position{ 0 };
+		char padding1[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+		std::atomic<uint64_t> read_position{ 0 };
+		char padding2[CACHE_LINE_SIZE - sizeof(std::atomic<uint64_t>)];
+
+		std::atomic<bool> writer_closed{ false };
+		std::atomic<bool> reader_closed{ false };
+		std::atomic<bool> writer_waiting{ false };
+		std::atomic<bool> reader_waiting{ false };
+
+		std::mutex mutex;
+		std::condition_variable readable;
+		std::condition_variable writable;
+
+		explicit State(count_type ring_capacity)
+			: ring(new byte_type[ring_capacity])
+			, capacity(ring_capacity)
+		{}
+
+		count_type readable_bytes() const
+		{
+			return static_cast<count_type>(write_position.load() - read_position.load());
+		}
+
+		count_type writable_bytes() const
+		{
+			return capacity - readable_bytes();
+		}
+
+		// the waiting flag and the position are both sequentially consistent, so either the sleeping side sees
+		// the new position before it waits or the other side sees the flag and notifies under the mutex
+		void wake(const std::atomic<bool>& waiting, std::condition_variable& condition)
+		{
+			if (waiting.load())
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				condition.notify_one();
+			}
+		}
+
+		template<typename predicate_type>
+		void wait(std::atomic<bool>& waiting, std::condition_variable& condition, predicate_type predicate)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			waiting.store(true);
+			condition.wait(lock, predicate);
+			waiting.store(false);
+		}
+
+		void close(std::atomic<bool>& closed)
+		{
+			closed.store(true);
+			std::lock_guard<std::mutex> lock(mutex);
+			readable.notify_all();
+			writable.notify_all();
+		}
+	};
+
+	template<typename byte_type>
+	constexpr typename PipeStream<byte_type>::count_type PipeStream<byte_type>::DEFAULT_CAPACITY;
+
+	template<typename byte_type>
+	PipeStream<byte_type>::PipeStream(const std::shared_ptr<State>& state, bool writer)
+		: state_(state)
+		, writer_(writer)
+	{}
+
+	template<typename byte_type>
+	PipeStream<byte_type>::PipeStream(PipeStream&& stream)
+		: state_(std::move(stream.state_))
+		, writer_(stream.writer_)
+		, blocking_(stream.blocking_)
+	{}
+
+	template<typename byte_type>
+	PipeStream<byte_type>& PipeStream<byte_type>::operator=(PipeStream&& stream)
+	{
+		if (this != &stream)
+		{
+			close();
+			state_ = std::move(stream.state_);
+			writer_ = stream.writer_;
+			blocking_ = stream.blocking_;
+		}
+
+		return *this;
+	}
+
+	template<typename byte_type>
+	PipeStream<byte_type>::~PipeStream()
+	{
+		try
+		{
+			close();
+		}
+		catch (...)
+		{}
+	}
+
+	template<typename byte_type>
+	std::pair<PipeStream<byte_type>, PipeStream<byte_type>> PipeStream<byte_type>::create(count_type capacity)
+	{
+		count_type ring_capacity{ 1 };
+
+		while (ring_capacity < capacity)
+		{
+			ring_capacity <<= 1;
+		}
+
+		auto state = std::make_shared<State>(ring_capacity);
+		return std::make_pair(PipeStream<byte_type>(state, true), PipeStream<byte_type>(state, false));
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::count_type PipeStream<byte_type>::capacity() const
+	{
+		CHECK_STREAM_STATE;
+		return state_->capacity;
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::count_type PipeStream<byte_type>::available() const
+	{
+		CHECK_STREAM_STATE;
+		return writer_ ? state_->writable_bytes() : state_->readable_bytes();
+	}
+
+	template<typename byte_type>
+	bool PipeStream<byte_type>::eof() const
+	{
+		CHECK_STREAM_STATE;
+		return state_->writer_closed.load() && state_->readable_bytes() == 0;
+	}
+
+	template<typename byte_type>
+	void PipeStream<byte_type>::close()
+	{
+		if (state_ != nullptr)
+		{
+			state_->close(writer_ ? state_->writer_closed : state_->reader_closed);
+			state_.reset();
+		}
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::size_type PipeStream<byte_type>::size() const
+	{
+		CHECK_STREAM_STATE;
+		return state_->write_position.load();
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::size_type PipeStream<byte_type>::tell() const
+	{
+		CHECK_STREAM_STATE;
+		return writer_ ? state_->write_position.load(std::memory_order_relaxed) : state_->read_position.load(std::memory_order_relaxed);
+	}
+
+	template<typename byte_type>
+	std::string PipeStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		CHECK_STREAM_STATE;
+		THROW_IF(writer_, IOStreamsException(errors::STREAM_WRITE_ONLY));
+
+		static constexpr count_type CHUNK_SIZE{ 64 * 1024 };
+		auto self = const_cast<PipeStream<byte_type>*>(this);
+		std::string result;
+		std::vector<byte_type> buffer(std::min(CHUNK_SIZE, state_->capacity));
+		count_type read_bytes{ 0 };
+
+		while ((read_bytes = self->read(buffer.data(), buffer.size())) > 0)
+		{
+			transform_to_string(transformer, buffer.data(), read_bytes, result);
+		}
+
+		finish_to_string(transformer, result);
+
+		return result;
+	}
+
+	template<typename byte_type>
+	void PipeStream<byte_type>::seek(off_type, std::ios_base::seekdir)
+	{
+		throw IOStreamsException(errors::STREAM_NOT_SEEKABLE);
+	}
+
+	template<typename byte_type>
+	void PipeStream<byte_type>::resize(size_type)
+	{
+		throw IOStreamsException(errors::STREAM_NOT_SEEKABLE);
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::count_type PipeStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		assert(buffer != nullptr);
+		CHECK_STREAM_STATE;
+		THROW_IF(writer_, IOStreamsException(errors::STREAM_WRITE_ONLY));
+
+		auto& state = *state_;
+		auto position = state.read_position.load(std::memory_order_relaxed);
+
+		while (count > 0)
+		{
+			auto ready = static_cast<count_type>(state.write_position.load(std::memory_order_acquire) - position);
+
+			if (ready > 0)
+			{
+				auto read_bytes = std::min(ready, count);
+				auto index = static_cast<count_type>(position & (state.capacity - 1));
+				auto first = std::min(read_bytes, state.capacity - index);
+				std::memcpy(buffer, state.ring.get() + index, first);
+				std::memcpy(buffer + first, state.ring.get(), read_bytes - first);
+
+				state.read_position.store(position + read_bytes);
+				state.wake(state.writer_waiting, state.writable);
+				return read_bytes;
+			}
+
+			if (state.writer_closed.load())
+			{
+				// the writer may have published its last bytes right before closing
+				if (state.write_position.load() != position)
+				{
+					continue;
+				}
+
+				break;
+			}
+
+			if (!blocking_)
+			{
+				break;
+			}
+
+			state.wait(state.reader_waiting, state.readable, [&state, position]()
+			{
+				return state.write_position.load() != position || state.writer_closed.load();
+			});
+		}
+
+		return 0;
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::count_type PipeStream<byte_type>::write(const byte_type* data, count_type size)
+	{
+		assert(data != nullptr || size == 0);
+		CHECK_STREAM_STATE;
+		THROW_IF(!writer_, IOStreamsException(errors::STREAM_READ_ONLY));
+
+		auto& state = *state_;
+		auto position = state.write_position.load(std::memory_order_relaxed);
+		count_type written_bytes{ 0 };
+
+		while (written_bytes < size)
+		{
+			THROW_IF(state.reader_closed.load(), IOStreamsException(errors::BROKEN_PIPE));
+			auto free = state.capacity - static_cast<count_type>(position - state.read_position.load(std::memory_order_acquire));
+
+			if (free > 0)
+			{
+				auto bytes = std::min(free, size - written_bytes);
+				auto index = static_cast<count_type>(position & (state.capacity - 1));
+				auto first = std::min(bytes, state.capacity - index);
+				std::memcpy(state.ring.get() + index, data + written_bytes, first);
+				std::memcpy(state.ring.get(), data + written_bytes + first, bytes - first);
+
+				position += bytes;
+				written_bytes += bytes;
+				state.write_position.store(position);
+				state.wake(state.reader_waiting, state.readable);
+				continue;
+			}
+
+			if (!blocking_)
+			{
+				break;
+			}
+
+			state.wait(state.writer_waiting, state.writable, [&state, position]()
+			{
+				return position - state.read_position.load() < state.capacity || state.reader_closed.load();
+			});
+		}
+
+		return written_bytes;
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::count_type PipeStream<byte_type>::pread(size_type, byte_type*, count_type) const
+	{
+		throw IOStreamsException(errors::STREAM_NOT_SEEKABLE);
+	}
+
+	template<typename byte_type>
+	typename PipeStream<byte_type>::count_type PipeStream<byte_type>::pwrite(size_type, const byte_type*, count_type)
+	{
+		throw IOStreamsException(errors::STREAM_NOT_SEEKABLE);
+	}
+
+	template class PipeStream<uint8_t>;
+	template class PipeStream<char>;
+}
\ No newline at end of file
@@ -0,0 +1,448 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/ring.h"
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+#if defined (__linux__) || defined (__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+
+#define CHECK_STREAM_STATE if (state_ == nullptr) throw IOStreamsException(errors::STREAM_CLOSE)
+
+namespace iostreams
+{
+	namespace
+	{
+#if defined (__linux__) || defined (__APPLE__)
+		size_t page_size()
+		{
+			return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+		}
+
+		// maps the same pages at [base, base + size) and [base + size, base + 2 * size), nullptr on failure
+		void* map_twice(size_t size)
+		{
+			int fd{ -1 };
+
+#if defined (__linux__) && defined (MFD_CLOEXEC)
+			fd = ::memfd_create("iostreams-ring", MFD_CLOEXEC);
+#endif
+
+			if (fd == -1)
+			{
+				char path[] = "/tmp/iostreams-ring.XXXXXX";
+				fd = ::mkstemp(path);
+
+				if (fd == -1)
+				{
+					return nullptr;
+				}
+
+				::unlink(path);
+			}
+
+			void* base{ MAP_FAILED };
+
+			if (::ftruncate(fd, static_cast<off_t>(size)) == 0)
+			{
+				base = ::mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			}
+
+			if (base != MAP_FAILED)
+			{
+				auto first = ::mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+				auto second = ::mmap(static_cast<uint8_t*>(base) + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+
+				if (first == MAP_FAILED || second == MAP_FAILED)
+				{
+					::munmap(base, 2 * size);
+					base = MAP_FAILED;
+				}
+			}
+
+			::close(fd);
+			return base != MAP_FAILED ? base : nullptr;
+		}
+#else
+		size_t page_size()
+		{
+			return 4096;
+		}
+#endif
+	}
+
+	template<typename byte_type>
+	struct RingStream<byte_type>::State
+	{
+		byte_type* data{ nullptr };
+		count_type capacity;
+		RingOverflow overflow;
+		bool double_mapped{ false };
+
+		size_type begin{ 0 };
+		size_type end{ 0 };
+		size_type position{ 0 };
+
+		std::mutex mutex;
+		std::condition_variable writable;
+
+		State(count_type ring_capacity, RingOverflow ring_overflow)
+			: capacity(ring_capacity)
+			, overflow(ring_overflow)
+		{
+#if defined (__linux__) || defined (__APPLE__)
+			data = static_cast<byte_type*>(map_twice(capacity));
+			double_mapped = data != nullptr;
+#endif
+
+			if (data == nullptr)
+			{
+				data = new byte_type[2 * capacity];
+			}
+		}
+
+		~State()
+		{
+#if defined (__linux__) || defined (__APPLE__)
+			if (double_mapped)
+			{
+				::munmap(data, 2 * capacity);
+				return;
+			}
+#endif
+			delete[] data;
+		}
+
+		State(const State&) = delete;
+		State& operator=(const State&) = delete;
+
+		byte_type* at(size_type offset) const
+		{
+			return data + static_cast<count_type>(offset % capacity);
+		}
+
+		// copies count <= capacity bytes (zeros when source is null) to the ring at offset
+		void store(size_type offset, const byte_type* source, count_type count)
+		{
+			auto index = static_cast<count_type>(offset % capacity);
+			fill(index, source, count);
+
+			if (!double_mapped)
+			{
+				// keeps the second half a copy of the first one, as the double mapping would
+				auto end = index + count;
+				auto head_end = std::min(end, capacity);
+
+				if (index < head_end)
+				{
+					fill(index + capacity, source, head_end - index);
+				}
+
+				if (end > capacity)
+				{
+					auto tail_begin = std::max(index, capacity);
+					fill(tail_begin - capacity, source != nullptr ? source + (tail_begin - index) : nullptr, end - tail_begin);
+				}
+			}
+		}
+
+		void fill(count_type index, const byte_type* source, count_type count)
+		{
+			if (source != nullptr)
+			{
+				std::memcpy(data + index, source, count);
+			}
+			else
+			{
+				std::memset(data + index, 0, count);
+			}
+		}
+
+		count_type append(const byte_type* source, count_type count, std::unique_lock<std::mutex>& lock)
+		{
+			count_type appended{ 0 };
+
+			if (overflow == RingOverflow::OVERWRITE && count > capacity)
+			{
+				// only the last capacity bytes can be retained
+				auto skipped = count - capacity;
+				end += skipped;
+				source = source != nullptr ? source + skipped : nullptr;
+				appended = skipped;
+				count = capacity;
+			}
+
+			while (count > 0)
+			{
+				count_type chunk{ 0 };
+
+				if (overflow == RingOverflow::OVERWRITE)
+				{
+					chunk = count;
+
+					if (end + chunk - begin > capacity)
+					{
+						begin = end + chunk - capacity;
+						position = std::max(position, begin);
+					}
+				}
+				else
+				{
+					writable.wait(lock, [this]() { return end - begin < capacity; });
+					chunk = std::min(count, capacity - static_cast<count_type>(end - begin));
+				}
+
+				store(end, source, chunk);
+				end += chunk;
+				source = source != nullptr ? source + chunk : nullptr;
+				appended += chunk;
+				count -= chunk;
+			}
+
+			return appended;
+		}
+	};
+
+	template<typename byte_type>
+	RingStream<byte_type>::RingStream(count_type capacity, RingOverflow overflow)
+	{
+		auto page = page_size();
+		capacity = std::max<count_type>(capacity, 1);
+		capacity = (capacity + page - 1) / page * page;
+		state_ = std::make_unique<State>(capacity, overflow);
+	}
+
+	template<typename byte_type>
+	RingStream<byte_type>::RingStream(RingStream&& stream)
+		: state_(std::move(stream.state_))
+	{}
+
+	template<typename byte_type>
+	RingStream<byte_type>& RingStream<byte_type>::operator=(RingStream&& stream)
+	{
+		state_ = std::move(stream.state_);
+		return *this;
+	}
+
+	template<typename byte_type>
+	RingStream<byte_type>::~RingStream() {}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::count_type RingStream<byte_type>::capacity() const
+	{
+		CHECK_STREAM_STATE;
+		return state_->capacity;
+	}
+
+	template<typename byte_type>
+	RingOverflow RingStream<byte_type>::overflow() const
+	{
+		CHECK_STREAM_STATE;
+		return state_->overflow;
+	}
+
+	template<typename byte_type>
+	bool RingStream<byte_type>::double_mapped() const
+	{
+		CHECK_STREAM_STATE;
+		return state_->double_mapped;
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::size_type RingStream<byte_type>::window_begin() const
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		return state_->begin;
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::count_type RingStream<byte_type>::window_size() const
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		return static_cast<count_type>(state_->end - state_->begin);
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::ConstBuffer RingStream<byte_type>::view() const
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		return { state_->at(state_->position), static_cast<count_type>(state_->end - state_->position) };
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::ConstBuffer RingStream<byte_type>::view(size_type offset, count_type count) const
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		THROW_IF(offset < state_->begin || offset > state_->end, IOStreamsException(errors::OUT_OF_RANGE));
+		return { state_->at(offset), static_cast<count_type>(std::min<size_type>(count, state_->end - offset)) };
+	}
+
+	template<typename byte_type>
+	void RingStream<byte_type>::consume(count_type count)
+	{
+		CHECK_STREAM_STATE;
+
+		{
+			std::lock_guard<std::mutex> lock(state_->mutex);
+			THROW_IF(count > state_->end - state_->begin, IOStreamsException(errors::OUT_OF_RANGE));
+			state_->begin += count;
+			state_->position = std::max(state_->position, state_->begin);
+		}
+
+		state_->writable.notify_one();
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::size_type RingStream<byte_type>::size() const
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		return state_->end;
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::size_type RingStream<byte_type>::tell() const
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		return state_->position;
+	}
+
+	template<typename byte_type>
+	std::string RingStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		std::string result;
+		auto window_size = static_cast<count_type>(state_->end - state_->begin);
+
+		if (window_size > 0)
+		{
+			result.reserve(transformer.required_size(window_size));
+
+			transform_to_string(transformer, state_->at(state_->begin), window_size, result);
+
+			finish_to_string(transformer, result);
+		}
+
+		return result;
+	}
+
+	template<typename byte_type>
+	void RingStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+
+		if (way == std::ios_base::cur)
+		{
+			off += static_cast<off_type>(state_->position);
+		}
+		else if (way == std::ios_base::end)
+		{
+			off += static_cast<off_type>(state_->end);
+		}
+
+		THROW_IF(off < 0 || static_cast<size_type>(off) < state_->begin || static_cast<size_type>(off) > state_->end, IOStreamsException(errors::OUT_OF_RANGE));
+		state_->position = static_cast<size_type>(off);
+	}
+
+	template<typename byte_type>
+	void RingStream<byte_type>::resize(size_type size)
+	{
+		CHECK_STREAM_STATE;
+		std::unique_lock<std::mutex> lock(state_->mutex);
+		THROW_IF(size < state_->begin, IOStreamsException(errors::OUT_OF_RANGE));
+
+		if (size <= state_->end)
+		{
+			state_->end = size;
+			state_->position = std::min(state_->position, size);
+		}
+		else
+		{
+			state_->append(nullptr, static_cast<count_type>(size - state_->end), lock);
+		}
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::count_type RingStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		assert(buffer != nullptr);
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+
+		auto read_bytes = static_cast<count_type>(std::min<size_type>(count, state_->end - state_->position));
+		std::memcpy(buffer, state_->at(state_->position), read_bytes);
+		state_->position += read_bytes;
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::count_type RingStream<byte_type>::write(const byte_type* data, count_type size)
+	{
+		assert(data != nullptr || size == 0);
+		CHECK_STREAM_STATE;
+		std::unique_lock<std::mutex> lock(state_->mutex);
+		return state_->append(data, size, lock);
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::count_type RingStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		assert(buffer != nullptr);
+		CHECK_STREAM_STATE;
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		THROW_IF(offset < state_->begin, IOStreamsException(errors::OUT_OF_RANGE));
+
+		if (offset >= state_->end)
+		{
+			return 0;
+		}
+
+		auto read_bytes = static_cast<count_type>(std::min<size_type>(count, state_->end - offset));
+		std::memcpy(buffer, state_->at(offset), read_bytes);
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename RingStream<byte_type>::count_type RingStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type size)
+	{
+		assert(data != nullptr || size == 0);
+		CHECK_STREAM_STATE;
+		std::unique_lock<std::mutex> lock(state_->mutex);
+		THROW_IF(offset < state_->begin, IOStreamsException(errors::OUT_OF_RANGE));
+
+		if (offset > state_->end)
+		{
+			state_->append(nullptr, static_cast<count_type>(offset - state_->end), lock);
+			THROW_IF(offset < state_->begin, IOStreamsException(errors::OUT_OF_RANGE));
+		}
+
+		auto in_place = static_cast<count_type>(std::min<size_type>(size, state_->end - offset));
+		state_->store(offset, data, in_place);
+		return in_place + state_->append(data + in_place, size - in_place, lock);
+	}
+
+	template class RingStream<uint8_t>;
+	template class RingStream<char>;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_SIMD_H_
+#define _IOSTREAMS_SIMD_H_
+
+#include <atomic>
+#include <cstdint>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+#define IOSTREAMS_X86
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang compile each kernel for its own instruction set, MSVC exposes every intrinsic anyway
+#if defined (__GNUC__) || defined (__clang__)
+#define IOSTREAMS_TARGET(features) __attribute__((target(features)))
+#else
+#define IOSTREAMS_TARGET(features)
+#endif
+
+namespace iostreams
+{
+	namespace simd
+	{
+		enum class Level : uint8_t
+		{
+			NONE = 0,
+			SSSE3,
+			AVX2,
+			// AVX-512 F, BW and VBMI
+			AVX512
+		};
+
+		inline Level detect_level()
+		{
+#if defined (IOSTREAMS_X86) && (defined (__GNUC__) || defined (__clang__))
+			__builtin_cpu_init();
+
+			if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi"))
+			{
+				return Level::AVX512;
+			}
+
+			if (__builtin_cpu_supports("avx2"))
+			{
+				return Level::AVX2;
+			}
+
+			if (__builtin_cpu_supports("ssse3"))
+			{
+				return Level::SSSE3;
+			}
+#elif defined (IOSTREAMS_X86) && defined (_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			auto max_leaf = info[0];
+
+			__cpuid(info, 1);
+			auto ssse3 = (info[2] & (1 << 9)) != 0;
+			auto os_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x06) == 0x06;
+			auto os_avx512 = os_avx && (_xgetbv(0) & 0xE6) == 0xE6;
+
+			if (max_leaf >= 7)
+			{
+				__cpuidex(info, 7, 0);
+
+				if (os_avx512 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0 && (info[2] & (1 << 1)) != 0)
+				{
+					return Level::AVX512;
+				}
+
+				if (os_avx && (info[1] & (1 << 5)) != 0)
+				{
+					return Level::AVX2;
+				}
+			}
+
+			if (ssse3)
+			{
+				return Level::SSSE3;
+			}
+#endif
+			return Level::NONE;
+		}
+
+		// a level forced by set_level(), -1 if none
+		inline std::atomic<int>& forced_level()
+		{
+			static std::atomic<int> value{ -1 };
+			return value;
+		}
+
+		// detected once per process, tests may force it lower to reach every kernel on one machine
+		inline Level level()
+		{
+			static const Level detected = detect_level();
+			auto forced = forced_level().load(std::memory_order_relaxed);
+			return forced >= 0 && forced < static_cast<int>(detected) ? static_cast<Level>(forced) : detected;
+		}
+
+		// caps the level for tests, never above the detected one
+		inline void set_level(Level value)
+		{
+			forced_level() = static_cast<int>(value);
+		}
+
+		inline void reset_level()
+		{
+			forced_level() = -1;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
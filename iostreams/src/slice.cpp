@@ -0,0 +1,136 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/slice.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace iostreams
+{
+	template<typename byte_type>
+	SliceStream<byte_type>::SliceStream(const std::shared_ptr<IStream<byte_type>>& stream, size_type offset, size_type length)
+		: stream_(stream)
+		, offset_(offset)
+		, length_(0)
+	{
+		assert(stream_ != nullptr);
+
+		auto stream_size = stream_->size();
+		length_ = offset_ < stream_size ? std::min(length, stream_size - offset_) : 0;
+	}
+
+	template<typename byte_type>
+	SliceStream<byte_type> SliceStream<byte_type>::slice(size_type offset, size_type length) const
+	{
+		THROW_IF(offset > length_ || length > length_ - offset, IOStreamsException(errors::OUT_OF_RANGE));
+		return SliceStream<byte_type>(stream_, offset_ + offset, length);
+	}
+
+	template<typename byte_type>
+	std::string SliceStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		static constexpr size_type CHUNK_SIZE{ 64 * 1024 };
+		std::string result;
+
+		if (length_ > 0)
+		{
+			THROW_IF(length_ > result.max_size(), IOStreamsException(errors::STREAM_SIZE_TOO_BIG));
+			result.reserve(transformer.required_size(static_cast<count_type>(length_)));
+
+			std::vector<byte_type> buffer(static_cast<size_t>(std::min(length_, CHUNK_SIZE)));
+			size_type offset{ 0 };
+			count_type read_bytes{ 0 };
+
+			while (offset < length_ && (read_bytes = pread(offset, buffer.data(), buffer.size())) > 0)
+			{
+				transform_to_string(transformer, buffer.data(), read_bytes, result);
+
+				offset += read_bytes;
+			}
+
+			finish_to_string(transformer, result);
+		}
+
+		return result;
+	}
+
+	template<typename byte_type>
+	void SliceStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		if (way == std::ios_base::cur)
+		{
+			off += static_cast<off_type>(position_);
+		}
+		else if (way == std::ios_base::end)
+		{
+			off += static_cast<off_type>(length_);
+		}
+
+		THROW_IF(off < 0 || static_cast<size_type>(off) > length_, IOStreamsException(errors::OUT_OF_RANGE));
+		position_ = static_cast<size_type>(off);
+	}
+
+	template<typename byte_type>
+	void SliceStream<byte_type>::resize(size_type size)
+	{
+		THROW_IF(size > length_, IOStreamsException(errors::OUT_OF_RANGE));
+		length_ = size;
+		position_ = std::min(position_, size);
+	}
+
+	template<typename byte_type>
+	typename SliceStream<byte_type>::count_type SliceStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		auto read_bytes = pread(position_, buffer, count);
+		position_ += read_bytes;
+		return read_bytes;
+	}
+
+	template<typename byte_type>
+	typename SliceStream<byte_type>::count_type SliceStream<byte_type>::write(const byte_type* data, count_type size)
+	{
+		auto written_bytes = pwrite(position_, data, size);
+		position_ += written_bytes;
+		return written_bytes;
+	}
+
+	template<typename byte_type>
+	typename SliceStream<byte_type>::count_type SliceStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		assert(buffer != nullptr);
+
+		if (offset >= length_)
+		{
+			return 0;
+		}
+
+		count = static_cast<count_type>(std::min<size_type>(count, length_ - offset));
+		return stream_->pread(offset_ + offset, buffer, count);
+	}
+
+	template<typename byte_type>
+	typename SliceStream<byte_type>::count_type SliceStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type size)
+	{
+		assert(data != nullptr || size == 0);
+
+		if (offset >= length_)
+		{
+			return 0;
+		}
+
+		size = static_cast<count_type>(std::min<size_type>(size, length_ - offset));
+		return stream_->pwrite(offset_ + offset, data, size);
+	}
+
+	template class SliceStream<uint8_t>;
+	template class SliceStream<char>;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/spill.h"
+#include <algorithm>
+
+namespace iostreams
+{
+	template<typename byte_type>
+	constexpr typename SpillStream<byte_type>::size_type SpillStream<byte_type>::DEFAULT_THRESHOLD;
+
+	template<typename byte_type>
+	SpillStream<byte_type>::SpillStream(size_type threshold, const std::string& directory)
+		: threshold_(threshold)
+		, directory_(directory)
+		, memory_(static_cast<typename MemoryStream<byte_type>::count_type>(std::min<size_type>(threshold, MemoryStream<byte_type>::DEFAULT_BLOCK_SIZE)))
+	{}
+
+	template<typename byte_type>
+	void SpillStream<byte_type>::spill()
+	{
+		if (file_)
+		{
+			return;
+		}
+
+		auto file = std::make_unique<FileStream<byte_type>>(FileStream<byte_type>::temporary(!directory_.empty() ? directory_.c_str() : nullptr));
+		THROW_IF(memory_.write_to(file.get()) != memory_.size(), IOStreamsException(errors::INCOMPLETE_WRITE));
+		file->seek(static_cast<off_type>(memory_.tell()));
+
+		file_ = std::move(file);
+		memory_ = MemoryStream<byte_type>(memory_.block_size(), memory_.allocator());
+	}
+
+	template<typename byte_type>
+	std::string SpillStream<byte_type>::to_string(IToStringTransform<byte_type>& transformer) const
+	{
+		return current()->to_string(transformer);
+	}
+
+	template<typename byte_type>
+	void SpillStream<byte_type>::seek(off_type off, std::ios_base::seekdir way)
+	{
+		current()->seek(off, way);
+	}
+
+	template<typename byte_type>
+	void SpillStream<byte_type>::resize(size_type size)
+	{
+		reserve(size);
+		current()->resize(size);
+	}
+
+	template<typename byte_type>
+	typename SpillStream<byte_type>::count_type SpillStream<byte_type>::read(byte_type* buffer, count_type count)
+	{
+		return current()->read(buffer, count);
+	}
+
+	template<typename byte_type>
+	typename SpillStream<byte_type>::count_type SpillStream<byte_type>::write(const byte_type* data, count_type size)
+	{
+		reserve(tell() + size);
+		return current()->write(data, size);
+	}
+
+	template<typename byte_type>
+	typename SpillStream<byte_type>::count_type SpillStream<byte_type>::pread(size_type offset, byte_type* buffer, count_type count) const
+	{
+		return current()->pread(offset, buffer, count);
+	}
+
+	template<typename byte_type>
+	typename SpillStream<byte_type>::count_type SpillStream<byte_type>::pwrite(size_type offset, const byte_type* data, count_type size)
+	{
+		reserve(offset + size);
+		return current()->pwrite(offset, data, size);
+	}
+
+	template<typename byte_type>
+	typename SpillStream<byte_type>::count_type SpillStream<byte_type>::readv(const Buffer* buffers, count_type count)
+	{
+		return current()->readv(buffers, count);
+	}
+
+	template<typename byte_type>
+	typename SpillStream<byte_type>::count_type SpillStream<byte_type>::writev(const ConstBuffer* buffers, count_type count)
+	{
+		size_type total{ 0 };
+
+		for (count_type i = 0; i < count; ++i)
+		{
+			total += buffers[i].size;
+		}
+
+		reserve(tell() + total);
+		return current()->writev(buffers, count);
+	}
+
+	template class SpillStream<uint8_t>;
+	template class SpillStream<char>;
+}
\ No newline at end of file
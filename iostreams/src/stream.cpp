@@ -10,9 +10,135 @@
 // SOFTWARE.
 
 #include "iostreams/stream.h"
+#include "iostreams/file.h"
+#include "iostreams/memory.h"
+#include <algorithm>
 #include <vector>
 #include <cassert>
 
+#ifdef __linux__
+#include "liberror/exception.h"
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	template<typename byte_type>
+	uint64_t copy_buffered(iostreams::IStream<byte_type>* source_stream, iostreams::IStream<byte_type>* destination_stream, uint64_t size)
+	{
+		static constexpr uint64_t BUFFER_SIZE{ 500 * 1024 };
+
+		std::vector<byte_type> buffer(static_cast<size_t>(std::min(size, BUFFER_SIZE)));
+		uint64_t copied_bytes{ 0 };
+
+		while (copied_bytes < size)
+		{
+			auto read_bytes = source_stream->read(buffer.data(), static_cast<size_t>(std::min<uint64_t>(buffer.size(), size - copied_bytes)));
+
+			if (read_bytes == 0)
+			{
+				break;
+			}
+
+			destination_stream->write(buffer.data(), read_bytes);
+			copied_bytes += read_bytes;
+		}
+
+		return copied_bytes;
+	}
+
+#ifdef __linux__
+	// the kernel copy bypasses write(): it would end up past the logical size a direct I/O destination keeps
+	// in user space, and the bytes would not count towards auto_flush or the flush policy
+	template<typename byte_type>
+	bool needs_write_path(iostreams::FileStream<byte_type>* destination_file)
+	{
+		auto policy = destination_file->flush_policy();
+		return destination_file->direct_io() || destination_file->auto_flush() || policy.bytes_threshold != 0 || policy.interval.count() != 0;
+	}
+
+	// copy_file_range lets reflink-capable filesystems share extents; sendfile covers older kernels and
+	// cross-filesystem copies, whatever neither of them can do goes through the buffered loop
+	template<typename byte_type>
+	uint64_t copy_file(iostreams::FileStream<byte_type>* source_file, iostreams::FileStream<byte_type>* destination_file, uint64_t size)
+	{
+		static constexpr uint64_t MAX_CHUNK_SIZE{ 1024 * 1024 * 1024 };
+
+		auto source_fd = source_file->native_handle();
+		auto destination_fd = destination_file->native_handle();
+		loff_t source_offset = source_file->tell();
+		loff_t destination_offset = destination_file->tell();
+
+		uint64_t copied_bytes{ 0 };
+		bool use_copy_file_range{ true };
+		bool use_sendfile{ true };
+
+		while (copied_bytes < size && use_sendfile)
+		{
+			auto chunk_size = static_cast<size_t>(std::min(size - copied_bytes, MAX_CHUNK_SIZE));
+			ssize_t ret;
+
+			if (use_copy_file_range)
+			{
+				ret = ::copy_file_range(source_fd, &source_offset, destination_fd, &destination_offset, chunk_size, 0);
+
+				if (ret == -1 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+				{
+					use_copy_file_range = false;
+					THROW_IF(::lseek64(destination_fd, destination_offset, SEEK_SET) == -1, POSIX_ERROR("lseek64"));
+					continue;
+				}
+			}
+			else
+			{
+				// sendfile writes at the file offset of the destination
+				ret = ::sendfile64(destination_fd, source_fd, &source_offset, chunk_size);
+
+				if (ret == -1 && (errno == EINVAL || errno == ENOSYS))
+				{
+					use_sendfile = false;
+					continue;
+				}
+
+				if (ret > 0)
+				{
+					destination_offset += ret;
+				}
+			}
+
+			if (ret == -1)
+			{
+				THROW_IF(errno != EINTR, POSIX_ERROR(use_copy_file_range ? "copy_file_range" : "sendfile64"));
+				continue;
+			}
+
+			if (ret == 0)
+			{
+				break;
+			}
+
+			copied_bytes += static_cast<uint64_t>(ret);
+		}
+
+		if (destination_file->cache_state())
+		{
+			destination_file->refresh();
+		}
+
+		source_file->seek(source_offset);
+		destination_file->seek(destination_offset);
+
+		if (!use_sendfile)
+		{
+			copied_bytes += copy_buffered<byte_type>(source_file, destination_file, size - copied_bytes);
+		}
+
+		return copied_bytes;
+	}
+#endif
+}
+
 template<typename byte_type>
 void iostreams::transform(IStream<byte_type>* source_stream, IStream<byte_type>* destination_stream, ITransform<byte_type, byte_type>& transformer)
 {
@@ -23,13 +149,13 @@ void iostreams::transform(IStream<byte_type>* source_stream, IStream<byte_type>*
 
 	THROW_IF(source_stream == destination_stream, IOStreamsException(errors::BAD_TRANSFORM_DESTINATION));
 
+	// reads until the end of the source instead of trusting size(), which is only a snapshot for a pipe
 	auto source_size = source_stream->size();
-	std::vector<byte_type> buffer(static_cast<size_type>(source_size > BUFFER_SIZE ? BUFFER_SIZE : source_size));
-	auto i = source_size / BUFFER_SIZE + (source_size % BUFFER_SIZE > 0 ? 1 : 0);
+	std::vector<byte_type> buffer(static_cast<size_type>(source_size > 0 && source_size < BUFFER_SIZE ? source_size : BUFFER_SIZE));
+	size_type read_bytes{ 0 };
 
-	while (i-- > 0)
+	while ((read_bytes = source_stream->read(buffer.data(), buffer.size())) > 0)
 	{
-		auto read_bytes = source_stream->read(buffer.data(), buffer.size());
 		transformer.update(buffer.data(), read_bytes, [destination_stream](const byte_type* data, size_type size)
 		{
 			destination_stream->write(data, size);
@@ -43,5 +169,49 @@ void iostreams::transform(IStream<byte_type>* source_stream, IStream<byte_type>*
 	destination_stream->seek(0);
 }
 
+template<typename byte_type>
+uint64_t iostreams::copy(IStream<byte_type>* source_stream, IStream<byte_type>* destination_stream, uint64_t size)
+{
+	assert(source_stream != nullptr && destination_stream != nullptr);
+
+	THROW_IF(source_stream == destination_stream, IOStreamsException(errors::BAD_TRANSFORM_DESTINATION));
+
+	auto source_position = source_stream->tell();
+	auto source_size = source_stream->size();
+	size = source_position < source_size ? std::min(size, source_size - source_position) : 0;
+
+	if (size == 0)
+	{
+		return 0;
+	}
+
+#ifdef __linux__
+	auto source_file = dynamic_cast<FileStream<byte_type>*>(source_stream);
+	auto destination_file = dynamic_cast<FileStream<byte_type>*>(destination_stream);
+
+	if (source_file != nullptr && destination_file != nullptr && !needs_write_path(destination_file))
+	{
+		return copy_file(source_file, destination_file, size);
+	}
+#endif
+
+	if (auto source_memory = dynamic_cast<MemoryStream<byte_type>*>(source_stream))
+	{
+		auto copied_bytes = source_memory->write_to(destination_stream, source_position, size);
+		source_memory->seek(source_position + copied_bytes);
+		return copied_bytes;
+	}
+
+	if (auto destination_memory = dynamic_cast<MemoryStream<byte_type>*>(destination_stream))
+	{
+		return destination_memory->read_from(source_stream, size);
+	}
+
+	return copy_buffered(source_stream, destination_stream, size);
+}
+
 template void iostreams::transform<char>(IStream<char>* source_stream, IStream<char>* destination_stream, ITransform<char, char>& transformer);
-template void iostreams::transform<uint8_t>(IStream<uint8_t>* source_stream, IStream<uint8_t>* destination_stream, ITransform<uint8_t, uint8_t>& transformer);
\ No newline at end of file
+template void iostreams::transform<uint8_t>(IStream<uint8_t>* source_stream, IStream<uint8_t>* destination_stream, ITransform<uint8_t, uint8_t>& transformer);
+
+template uint64_t iostreams::copy<char>(IStream<char>* source_stream, IStream<char>* destination_stream, uint64_t size);
+template uint64_t iostreams::copy<uint8_t>(IStream<uint8_t>* source_stream, IStream<uint8_t>* destination_stream, uint64_t size);
\ No newline at end of file
@@ -0,0 +1,164 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_THREAD_POOL_H_
+#define _IOSTREAMS_THREAD_POOL_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iostreams
+{
+	// Fixed set of worker threads for data parallel work. The process-wide pool is created on first use with
+	// a worker per hardware thread except the calling one.
+	class ThreadPool
+	{
+	private:
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		std::deque<std::function<void()>> tasks_;
+		std::vector<std::thread> threads_;
+		bool stop_{ false };
+
+	public:
+		explicit ThreadPool(size_t size)
+		{
+			threads_.reserve(size);
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				threads_.emplace_back(&ThreadPool::work, this);
+			}
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		~ThreadPool()
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+
+			cv_.notify_all();
+
+			for (auto& thread : threads_)
+			{
+				thread.join();
+			}
+		}
+
+		static ThreadPool& shared()
+		{
+			static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+			return pool;
+		}
+
+		size_t size() const { return threads_.size(); }
+
+		std::future<void> submit(std::function<void()> task)
+		{
+			// std::function needs a copyable target
+			auto packaged_task = std::make_shared<std::packaged_task<void()>>(std::move(task));
+			auto result = packaged_task->get_future();
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				tasks_.emplace_back([packaged_task]() { (*packaged_task)(); });
+			}
+
+			cv_.notify_one();
+			return result;
+		}
+
+		// runs task(0) on the calling thread and the rest on the pool, returns when all of them have finished
+		// and rethrows the first failure
+		void run(size_t count, const std::function<void(size_t)>& task)
+		{
+			std::vector<std::future<void>> results;
+			results.reserve(count);
+
+			for (size_t i = 1; i < count; ++i)
+			{
+				results.push_back(submit([&task, i]() { task(i); }));
+			}
+
+			std::exception_ptr error;
+
+			try
+			{
+				if (count > 0)
+				{
+					task(0);
+				}
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			for (auto& result : results)
+			{
+				try
+				{
+					result.get();
+				}
+				catch (...)
+				{
+					if (!error)
+					{
+						error = std::current_exception();
+					}
+				}
+			}
+
+			if (error)
+			{
+				std::rethrow_exception(error);
+			}
+		}
+
+	private:
+		void work()
+		{
+			while (true)
+			{
+				std::function<void()> task;
+
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+
+					if (tasks_.empty())
+					{
+						return;
+					}
+
+					task = std::move(tasks_.front());
+					tasks_.pop_front();
+				}
+
+				task();
+			}
+		}
+	};
+}
+
+#endif
\ No newline at end of file
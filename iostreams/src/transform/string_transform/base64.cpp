@@ -11,282 +11,81 @@
 
 #include "iostreams/transform/string_transform/base64.h"
 #include "iostreams/error.h"
+#include "base64_simd.h"
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <cassert>
 
 static constexpr char CHARPAD{ '=' };
-static constexpr uint32_t BADCHAR{ 0x01FFFFFF };
-
-static constexpr char e0[256]{
-        'A', 'A', 'A', 'A', 'B', 'B', 'B', 'B', 'C', 'C',
-        'C', 'C', 'D', 'D', 'D', 'D', 'E', 'E', 'E', 'E',
-        'F', 'F', 'F', 'F', 'G', 'G', 'G', 'G', 'H', 'H',
-        'H', 'H', 'I', 'I', 'I', 'I', 'J', 'J', 'J', 'J',
-        'K', 'K', 'K', 'K', 'L', 'L', 'L', 'L', 'M', 'M',
-        'M', 'M', 'N', 'N', 'N', 'N', 'O', 'O', 'O', 'O',
-        'P', 'P', 'P', 'P', 'Q', 'Q', 'Q', 'Q', 'R', 'R',
-        'R', 'R', 'S', 'S', 'S', 'S', 'T', 'T', 'T', 'T',
-        'U', 'U', 'U', 'U', 'V', 'V', 'V', 'V', 'W', 'W',
-        'W', 'W', 'X', 'X', 'X', 'X', 'Y', 'Y', 'Y', 'Y',
-        'Z', 'Z', 'Z', 'Z', 'a', 'a', 'a', 'a', 'b', 'b',
-        'b', 'b', 'c', 'c', 'c', 'c', 'd', 'd', 'd', 'd',
-        'e', 'e', 'e', 'e', 'f', 'f', 'f', 'f', 'g', 'g',
-        'g', 'g', 'h', 'h', 'h', 'h', 'i', 'i', 'i', 'i',
-        'j', 'j', 'j', 'j', 'k', 'k', 'k', 'k', 'l', 'l',
-        'l', 'l', 'm', 'm', 'm', 'm', 'n', 'n', 'n', 'n',
-        'o', 'o', 'o', 'o', 'p', 'p', 'p', 'p', 'q', 'q',
-        'q', 'q', 'r', 'r', 'r', 'r', 's', 's', 's', 's',
-        't', 't', 't', 't', 'u', 'u', 'u', 'u', 'v', 'v',
-        'v', 'v', 'w', 'w', 'w', 'w', 'x', 'x', 'x', 'x',
-        'y', 'y', 'y', 'y', 'z', 'z', 'z', 'z', '0', '0',
-        '0', '0', '1', '1', '1', '1', '2', '2', '2', '2',
-        '3', '3', '3', '3', '4', '4', '4', '4', '5', '5',
-        '5', '5', '6', '6', '6', '6', '7', '7', '7', '7',
-        '8', '8', '8', '8', '9', '9', '9', '9', '+', '+',
-        '+', '+', '/', '/', '/', '/'
-};
+static constexpr uint8_t BADVALUE{ 0xFF };
 
-static constexpr char e1[256]{
-        'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J',
-        'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T',
-        'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd',
-        'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n',
-        'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x',
-        'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7',
-        '8', '9', '+', '/', 'A', 'B', 'C', 'D', 'E', 'F',
-        'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
-        'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
-        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
-        'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
-        'u', 'v', 'w', 'x', 'y', 'z', '0', '1', '2', '3',
-        '4', '5', '6', '7', '8', '9', '+', '/', 'A', 'B',
-        'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L',
-        'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V',
-        'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
-        'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
-        'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
-        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-        '+', '/', 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H',
-        'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R',
-        'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b',
-        'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l',
-        'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
-        'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5',
-        '6', '7', '8', '9', '+', '/'
-};
+static constexpr char STANDARD_ALPHABET[64 + 1]{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+static constexpr char URL_SAFE_ALPHABET[64 + 1]{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_" };
 
-static constexpr char e2[256]{
-        'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J',
-        'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T',
-        'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd',
-        'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n',
-        'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x',
-        'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7',
-        '8', '9', '+', '/', 'A', 'B', 'C', 'D', 'E', 'F',
-        'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
-        'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
-        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
-        'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
-        'u', 'v', 'w', 'x', 'y', 'z', '0', '1', '2', '3',
-        '4', '5', '6', '7', '8', '9', '+', '/', 'A', 'B',
-        'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L',
-        'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V',
-        'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
-        'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
-        'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
-        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-        '+', '/', 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H',
-        'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R',
-        'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b',
-        'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l',
-        'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
-        'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5',
-        '6', '7', '8', '9', '+', '/'
-};
+// 6-bit value of every character, BADVALUE for characters outside the alphabet
+struct DecodeTable
+{
+	uint8_t values[256];
 
-static constexpr uint32_t d0[256]{
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x000000f8, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x000000fc,
-        0x000000d0, 0x000000d4, 0x000000d8, 0x000000dc, 0x000000e0, 0x000000e4,
-        0x000000e8, 0x000000ec, 0x000000f0, 0x000000f4, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x00000000,
-        0x00000004, 0x00000008, 0x0000000c, 0x00000010, 0x00000014, 0x00000018,
-        0x0000001c, 0x00000020, 0x00000024, 0x00000028, 0x0000002c, 0x00000030,
-        0x00000034, 0x00000038, 0x0000003c, 0x00000040, 0x00000044, 0x00000048,
-        0x0000004c, 0x00000050, 0x00000054, 0x00000058, 0x0000005c, 0x00000060,
-        0x00000064, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x00000068, 0x0000006c, 0x00000070, 0x00000074, 0x00000078,
-        0x0000007c, 0x00000080, 0x00000084, 0x00000088, 0x0000008c, 0x00000090,
-        0x00000094, 0x00000098, 0x0000009c, 0x000000a0, 0x000000a4, 0x000000a8,
-        0x000000ac, 0x000000b0, 0x000000b4, 0x000000b8, 0x000000bc, 0x000000c0,
-        0x000000c4, 0x000000c8, 0x000000cc, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff
-};
+	constexpr DecodeTable(const char* alphabet)
+		: values()
+	{
+		for (auto i = 0; i < 256; ++i)
+		{
+			values[i] = BADVALUE;
+		}
 
-static constexpr uint32_t d1[256]{
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x0000e003, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x0000f003,
-        0x00004003, 0x00005003, 0x00006003, 0x00007003, 0x00008003, 0x00009003,
-        0x0000a003, 0x0000b003, 0x0000c003, 0x0000d003, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x00000000,
-        0x00001000, 0x00002000, 0x00003000, 0x00004000, 0x00005000, 0x00006000,
-        0x00007000, 0x00008000, 0x00009000, 0x0000a000, 0x0000b000, 0x0000c000,
-        0x0000d000, 0x0000e000, 0x0000f000, 0x00000001, 0x00001001, 0x00002001,
-        0x00003001, 0x00004001, 0x00005001, 0x00006001, 0x00007001, 0x00008001,
-        0x00009001, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x0000a001, 0x0000b001, 0x0000c001, 0x0000d001, 0x0000e001,
-        0x0000f001, 0x00000002, 0x00001002, 0x00002002, 0x00003002, 0x00004002,
-        0x00005002, 0x00006002, 0x00007002, 0x00008002, 0x00009002, 0x0000a002,
-        0x0000b002, 0x0000c002, 0x0000d002, 0x0000e002, 0x0000f002, 0x00000003,
-        0x00001003, 0x00002003, 0x00003003, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff
+		for (uint8_t i = 0; i < 64; ++i)
+		{
+			values[static_cast<uint8_t>(alphabet[i])] = i;
+		}
+	}
 };
 
-static constexpr uint32_t d2[256]{
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x00800f00, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x00c00f00,
-	0x00000d00, 0x00400d00, 0x00800d00, 0x00c00d00, 0x00000e00, 0x00400e00,
-	0x00800e00, 0x00c00e00, 0x00000f00, 0x00400f00, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x00000000,
-	0x00400000, 0x00800000, 0x00c00000, 0x00000100, 0x00400100, 0x00800100,
-	0x00c00100, 0x00000200, 0x00400200, 0x00800200, 0x00c00200, 0x00000300,
-	0x00400300, 0x00800300, 0x00c00300, 0x00000400, 0x00400400, 0x00800400,
-	0x00c00400, 0x00000500, 0x00400500, 0x00800500, 0x00c00500, 0x00000600,
-	0x00400600, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x00800600, 0x00c00600, 0x00000700, 0x00400700, 0x00800700,
-	0x00c00700, 0x00000800, 0x00400800, 0x00800800, 0x00c00800, 0x00000900,
-	0x00400900, 0x00800900, 0x00c00900, 0x00000a00, 0x00400a00, 0x00800a00,
-	0x00c00a00, 0x00000b00, 0x00400b00, 0x00800b00, 0x00c00b00, 0x00000c00,
-	0x00400c00, 0x00800c00, 0x00c00c00, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-	0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff
-};
+static constexpr DecodeTable STANDARD_VALUES{ STANDARD_ALPHABET };
+static constexpr DecodeTable URL_SAFE_VALUES{ URL_SAFE_ALPHABET };
 
-static constexpr uint32_t d3[256]{
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x003e0000, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x003f0000,
-        0x00340000, 0x00350000, 0x00360000, 0x00370000, 0x00380000, 0x00390000,
-        0x003a0000, 0x003b0000, 0x003c0000, 0x003d0000, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x00000000,
-        0x00010000, 0x00020000, 0x00030000, 0x00040000, 0x00050000, 0x00060000,
-        0x00070000, 0x00080000, 0x00090000, 0x000a0000, 0x000b0000, 0x000c0000,
-        0x000d0000, 0x000e0000, 0x000f0000, 0x00100000, 0x00110000, 0x00120000,
-        0x00130000, 0x00140000, 0x00150000, 0x00160000, 0x00170000, 0x00180000,
-        0x00190000, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x001a0000, 0x001b0000, 0x001c0000, 0x001d0000, 0x001e0000,
-        0x001f0000, 0x00200000, 0x00210000, 0x00220000, 0x00230000, 0x00240000,
-        0x00250000, 0x00260000, 0x00270000, 0x00280000, 0x00290000, 0x002a0000,
-        0x002b0000, 0x002c0000, 0x002d0000, 0x002e0000, 0x002f0000, 0x00300000,
-        0x00310000, 0x00320000, 0x00330000, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff,
-        0x01ffffff, 0x01ffffff, 0x01ffffff, 0x01ffffff
-};
+static inline const char* Alphabet(iostreams::Base64Alphabet alphabet)
+{
+	return alphabet == iostreams::Base64Alphabet::URL_SAFE ? URL_SAFE_ALPHABET : STANDARD_ALPHABET;
+}
+
+static inline const uint8_t* DecodeValues(iostreams::Base64Alphabet alphabet)
+{
+	return alphabet == iostreams::Base64Alphabet::URL_SAFE ? URL_SAFE_VALUES.values : STANDARD_VALUES.values;
+}
+
+static inline void EncodeBlock(const uint8_t* data, char* out, const char* alphabet)
+{
+	out[0] = alphabet[data[0] >> 2];
+	out[1] = alphabet[((data[0] & 0x03) << 4) | (data[1] >> 4)];
+	out[2] = alphabet[((data[1] & 0x0F) << 2) | (data[2] >> 6)];
+	out[3] = alphabet[data[2] & 0x3F];
+}
+
+static inline bool DecodeBlock(const char* data, uint8_t* out, const uint8_t* values)
+{
+	uint8_t v0 = values[static_cast<uint8_t>(data[0])];
+	uint8_t v1 = values[static_cast<uint8_t>(data[1])];
+	uint8_t v2 = values[static_cast<uint8_t>(data[2])];
+	uint8_t v3 = values[static_cast<uint8_t>(data[3])];
+
+	if (((v0 | v1 | v2 | v3) & 0x80) != 0)
+	{
+		return false;
+	}
+
+	out[0] = static_cast<uint8_t>((v0 << 2) | (v1 >> 4));
+	out[1] = static_cast<uint8_t>((v1 << 4) | (v2 >> 2));
+	out[2] = static_cast<uint8_t>((v2 << 6) | v3);
+	return true;
+}
+
+static inline bool IsLineBreak(char ch)
+{
+	return ch == '\r' || ch == '\n';
+}
 
 namespace iostreams
 {
@@ -298,159 +97,370 @@ namespace iostreams
 	}
 
 	template<typename byte_type>
-	void FromBase64Transform<byte_type>::update(const char* data, size_type size, const transform_handler& handler)
+	typename FromBase64Transform<byte_type>::size_type FromBase64Transform<byte_type>::significant_size(const char* data, size_type size) const
+	{
+		size_type skipped{ 0 };
+
+		for (size_type i = 0; i < size; ++i)
+		{
+			skipped += (data[i] == '\r') | (data[i] == '\n') | (data[i] == CHARPAD);
+		}
+
+		return size - skipped;
+	}
+
+	template<typename byte_type>
+	std::unique_ptr<StringTransform<char, byte_type>> FromBase64Transform<byte_type>::fork() const
+	{
+		return std::unique_ptr<StringTransform<char, byte_type>>(new FromBase64Transform(this->buffer_.size(), alphabet_));
+	}
+
+	template<typename byte_type>
+	TransformResult FromBase64Transform<byte_type>::transform_into(const char* data, size_type size, byte_type* output, size_type capacity)
 	{
-		if (data != nullptr && size > 0)
+		TransformResult result;
+
+		if (data == nullptr || size == 0)
+		{
+			return result;
+		}
+
+		auto length = size;
+
+		while (length > 0 && IsLineBreak(data[length - 1]))
+		{
+			--length;
+		}
+
+		if (length > 0 && data[length - 1] == CHARPAD)
+		{
+			--length;
+
+			if (length > 0 && data[length - 1] == CHARPAD)
+			{
+				--length;
+			}
+		}
+
+		auto values = DecodeValues(alphabet_);
+		auto out = reinterpret_cast<uint8_t*>(output);
+
+		while (result.consumed < length)
 		{
-			if (data[size - 1] == CHARPAD)
+			if (i_ == 0)
 			{
-				--size;
+				while (result.consumed < length && IsLineBreak(data[result.consumed]))
+				{
+					++result.consumed;
+				}
+
+				if (result.consumed == length)
+				{
+					break;
+				}
+
+				// decode up to the next line break, or as much as fits into the output
+				auto input = data + result.consumed;
+				auto space = capacity - result.produced;
+				auto line = std::min(length - result.consumed, space / 3 * 4 + 2);
+				auto line_break = static_cast<const char*>(std::memchr(input, '\n', line));
 
-				if (size > 0 && data[size - 1] == CHARPAD)
+				if (line_break != nullptr)
 				{
-					--size;
+					line = line_break - input;
+				}
+
+				if (line > 0 && input[line - 1] == '\r')
+				{
+					--line;
+				}
+
+				auto count = std::min(line / 4, space / 3) * 4;
+				auto decoded = out + result.produced;
+				auto consumed = simd::decode_base64(input, count, decoded, values);
+
+				// the vector kernels leave the tail of the line and the block with a bad character
+				while (consumed < count && DecodeBlock(input + consumed, decoded + consumed / 4 * 3, values))
+				{
+					consumed += 4;
+				}
+
+				result.consumed += consumed;
+				result.produced += consumed / 4 * 3;
+
+				if (consumed > 0)
+				{
+					continue;
 				}
 			}
 
-			while (size-- > 0)
+			auto ch = data[result.consumed];
+
+			if (!IsLineBreak(ch))
 			{
-				auto ch = *data++;
+				auto value = values[static_cast<uint8_t>(ch)];
+				THROW_IF(value == BADVALUE, IOStreamsException(errors::BAD_BASE64_CHARACTER));
 
-				if (ch != '\r' && ch != '\n')
+				if (i_ == 3)
 				{
-					block4_[i_++] = ch;
-
-					if (i_ == 4)
+					if (capacity - result.produced < 3)
 					{
-						uint32_t y;
-						std::memcpy(&y, block4_, sizeof(y));
-
-						uint32_t x = d0[y & 0xFF] | d1[(y >> 8) & 0xFF] | d2[(y >> 16) & 0xFF] | d3[(y >> 24) & 0xFF];
-						THROW_IF(x >= BADCHAR, IOStreamsException(errors::BAD_BASE64_CHARACTER));
-						
-						if (this->buffer_index_ + 3 > this->buffer_.size())
-						{
-							this->flush(handler);
-						}
-
-						this->buffer_[this->buffer_index_++] = x & 0xFF;
-						this->buffer_[this->buffer_index_++] = (x >> 8) & 0xFF;
-						this->buffer_[this->buffer_index_++] = (x >> 16) & 0xFF;
-
-						block4_[0] = 0;
-						block4_[1] = 0;
-						block4_[2] = 0;
-						block4_[3] = 0;
-						i_ = 0;
+						break;
 					}
+
+					out[result.produced++] = static_cast<uint8_t>((block4_[0] << 2) | (block4_[1] >> 4));
+					out[result.produced++] = static_cast<uint8_t>((block4_[1] << 4) | (block4_[2] >> 2));
+					out[result.produced++] = static_cast<uint8_t>((block4_[2] << 6) | value);
+					i_ = 0;
+				}
+				else
+				{
+					block4_[i_++] = value;
 				}
 			}
+
+			++result.consumed;
+		}
+
+		// the skipped line breaks and padding at the end
+		if (result.consumed == length)
+		{
+			result.consumed = size;
+		}
+
+		return result;
+	}
+
+	template<typename byte_type>
+	typename FromBase64Transform<byte_type>::size_type FromBase64Transform<byte_type>::finish_into(byte_type* output, size_type capacity)
+	{
+		size_type count = i_ == 3 ? 2 : (i_ > 0 ? 1 : 0);
+		THROW_IF(capacity < count, IOStreamsException(errors::BUFFER_TOO_SMALL));
+
+		// the last block without padding
+		switch (i_)
+		{
+		case 1:
+			output[0] = static_cast<uint8_t>(block4_[0] << 2);
+			break;
+		case 2:
+			output[0] = static_cast<uint8_t>((block4_[0] << 2) | (block4_[1] >> 4));
+			break;
+		case 3:
+			output[0] = static_cast<uint8_t>((block4_[0] << 2) | (block4_[1] >> 4));
+			output[1] = static_cast<uint8_t>((block4_[1] << 4) | (block4_[2] >> 2));
+			break;
 		}
+
+		i_ = 0;
+		return count;
+	}
+
+	template<typename byte_type>
+	void FromBase64Transform<byte_type>::update(const char* data, size_type size, const transform_handler& handler)
+	{
+		this->update_into_buffer(data, size, handler);
 	}
 
 	template<typename byte_type>
 	void FromBase64Transform<byte_type>::update_final(const transform_handler& handler)
 	{
-		if (this->buffer_index_ >= 0)
+		this->final_into_buffer(handler);
+	}
+
+	template<typename byte_type>
+	ToBase64Transform<byte_type>::ToBase64Transform(size_t buffer_size, const Base64Options& options)
+		: base_type(buffer_size)
+		, options_(options)
+	{
+		THROW_IF(options_.line_length % 4 != 0, IOStreamsException(errors::BAD_BASE64_LINE_LENGTH));
+	}
+
+	template<typename byte_type>
+	typename ToBase64Transform<byte_type>::size_type ToBase64Transform<byte_type>::required_size(size_type size) const
+	{
+		auto result = size / 3 * 4;
+
+		if (size % 3 != 0)
+		{
+			result += options_.padding ? 4 : size % 3 + 1;
+		}
+
+		if (options_.line_length != 0 && result > 0)
 		{
-			uint32_t y;
-			std::memcpy(&y, block4_, sizeof(y));
+			result += (result - 1) / options_.line_length * (options_.line_break == LineBreak::CRLF ? 2 : 1);
+		}
 
-			uint32_t x{ 0 };
+		return result;
+	}
 
-			if (this->buffer_index_ + 2 > this->buffer_.size())
-			{
-				this->flush(handler);
-			}
+	template<typename byte_type>
+	typename ToBase64Transform<byte_type>::size_type ToBase64Transform<byte_type>::split_phase() const
+	{
+		return options_.line_length != 0 ? column_ % options_.line_length / 4 * 3 + i_ : i_;
+	}
+
+	template<typename byte_type>
+	std::unique_ptr<StringTransform<byte_type, char>> ToBase64Transform<byte_type>::fork() const
+	{
+		std::unique_ptr<ToBase64Transform> result(new ToBase64Transform(this->buffer_.size(), options_));
+		// the piece before ends with a full line
+		result->column_ = options_.line_length;
+		return result;
+	}
+
+	template<typename byte_type>
+	typename ToBase64Transform<byte_type>::size_type ToBase64Transform<byte_type>::line_break_size() const
+	{
+		// a line is broken in front of the block that does not fit, so the output never ends with a line break
+		if (options_.line_length != 0 && column_ >= options_.line_length)
+		{
+			return options_.line_break == LineBreak::CRLF ? 2 : 1;
+		}
 
-			switch (i_)
+		return 0;
+	}
+
+	template<typename byte_type>
+	typename ToBase64Transform<byte_type>::size_type ToBase64Transform<byte_type>::put_line_break(char* output)
+	{
+		auto count = line_break_size();
+
+		if (count != 0)
+		{
+			if (options_.line_break == LineBreak::CRLF)
 			{
-			case 1:
-				x = d0[y & 0xFF];
-				this->buffer_[this->buffer_index_++] = *reinterpret_cast<uint8_t*>(&x);
-				break;
-			case 2:
-				x = d0[y & 0xFF] | d1[y >> 8 & 0xFF];
-				this->buffer_[this->buffer_index_++] = *reinterpret_cast<uint8_t*>(&x);
-				break;
-			case 3:
-				x = d0[y & 0xFF] | d1[y >> 8 & 0xFF] | d2[y >> 16 & 0xFF];
-				this->buffer_[this->buffer_index_++] = reinterpret_cast<uint8_t*>(&x)[0];
-				this->buffer_[this->buffer_index_++] = reinterpret_cast<uint8_t*>(&x)[1];
-				break;
+				*output++ = '\r';
 			}
 
-			this->flush(handler);
+			*output = '\n';
+			column_ = 0;
 		}
 
-		block4_[0] = 0;
-		block4_[1] = 0;
-		block4_[2] = 0;
-		block4_[3] = 0;
-		i_ = 0;
-		this->buffer_index_ = 0;
+		return count;
 	}
 
 	template<typename byte_type>
-	void ToBase64Transform<byte_type>::update(const byte_type* data, size_type size, const transform_handler& handler)
+	typename ToBase64Transform<byte_type>::size_type ToBase64Transform<byte_type>::put_block(char* output)
 	{
-		if (data != nullptr && size > 0)
+		auto line_break = put_line_break(output);
+		output += line_break;
+
+		for (auto i = i_; i < 3; ++i)
 		{
-			while (size-- > 0)
-			{
-				block3_[i_++] = *data++;
+			block3_[i] = 0;
+		}
 
-				if (i_ == 3)
-				{
-					this->buffer_[this->buffer_index_++] = e0[block3_[0]];
-					this->buffer_[this->buffer_index_++] = e1[((block3_[0] & 0x03) << 4) | ((block3_[1] >> 4) & 0x0F)];
-					this->buffer_[this->buffer_index_++] = e1[((block3_[1] & 0x0F) << 2) | ((block3_[2] >> 6) & 0x03)];
-					this->buffer_[this->buffer_index_++] = e2[block3_[2]];
-					
-					if (this->buffer_index_ + 4 > this->buffer_.size())
-					{
-						this->flush(handler);
-					}
+		EncodeBlock(block3_, output, Alphabet(options_.alphabet));
 
-					block3_[0] = 0;
-					block3_[1] = 0;
-					block3_[2] = 0;
-					i_ = 0;
-				}
+		size_type count{ 4 };
+
+		if (i_ < 3)
+		{
+			if (options_.padding)
+			{
+				std::fill(output + i_ + 1, output + 4, CHARPAD);
+			}
+			else
+			{
+				count = i_ + 1;
 			}
 		}
+
+		column_ += static_cast<uint32_t>(count);
+		i_ = 0;
+		return line_break + count;
 	}
-	
+
 	template<typename byte_type>
-	void ToBase64Transform<byte_type>::update_final(const transform_handler& handler)
+	TransformResult ToBase64Transform<byte_type>::transform_into(const byte_type* data, size_type size, char* output, size_type capacity)
 	{
-		if (this->buffer_index_ >= 0)
+		TransformResult result;
+
+		if (data == nullptr)
 		{
-			if (this->buffer_index_ + 4 > this->buffer_.size())
-			{
-				this->flush(handler);
-			}
+			return result;
+		}
 
-			if (i_ > 0)
+		auto alphabet = Alphabet(options_.alphabet);
+
+		while (result.consumed < size)
+		{
+			if (i_ == 0 && size - result.consumed >= 3)
 			{
-				if (i_ == 1)
+				if (capacity - result.produced < line_break_size() + 4)
 				{
-					this->buffer_[this->buffer_index_++] = e0[block3_[0]];
-					this->buffer_[this->buffer_index_++] = e1[(block3_[0] & 0x03) << 4];
-					this->buffer_[this->buffer_index_++] = CHARPAD;
-					this->buffer_[this->buffer_index_++] = CHARPAD;
+					break;
 				}
-				else
+
+				result.produced += put_line_break(output + result.produced);
+
+				auto blocks = std::min((size - result.consumed) / 3, (capacity - result.produced) / 4);
+
+				if (options_.line_length != 0)
+				{
+					blocks = std::min<size_type>(blocks, (options_.line_length - column_) / 4);
+				}
+
+				auto input = reinterpret_cast<const uint8_t*>(data + result.consumed);
+				auto encoded = output + result.produced;
+				auto count = blocks * 3;
+				auto consumed = simd::encode_base64(input, count, encoded, alphabet);
+
+				for (; consumed < count; consumed += 3)
+				{
+					EncodeBlock(input + consumed, encoded + consumed / 3 * 4, alphabet);
+				}
+
+				result.consumed += count;
+				result.produced += blocks * 4;
+				column_ += static_cast<uint32_t>(blocks * 4);
+				continue;
+			}
+
+			if (i_ == 2)
+			{
+				if (capacity - result.produced < line_break_size() + 4)
 				{
-					this->buffer_[this->buffer_index_++] = e0[block3_[0]];
-					this->buffer_[this->buffer_index_++] = e1[((block3_[0] & 0x03) << 4) | ((block3_[1] >> 4) & 0x0F)];
-					this->buffer_[this->buffer_index_++] = e2[(block3_[1] & 0x0F) << 2];
-					this->buffer_[this->buffer_index_++] = CHARPAD;
+					break;
 				}
+
+				block3_[i_++] = data[result.consumed++];
+				result.produced += put_block(output + result.produced);
+				continue;
 			}
 
-			this->flush(handler);
+			block3_[i_++] = data[result.consumed++];
+		}
+
+		return result;
+	}
+
+	template<typename byte_type>
+	typename ToBase64Transform<byte_type>::size_type ToBase64Transform<byte_type>::finish_into(char* output, size_type capacity)
+	{
+		size_type count{ 0 };
+
+		if (i_ > 0)
+		{
+			THROW_IF(capacity < line_break_size() + 4, IOStreamsException(errors::BUFFER_TOO_SMALL));
+			count = put_block(output);
 		}
+
+		column_ = 0;
+		return count;
+	}
+
+	template<typename byte_type>
+	void ToBase64Transform<byte_type>::update(const byte_type* data, size_type size, const transform_handler& handler)
+	{
+		this->update_into_buffer(data, size, handler);
+	}
+
+	template<typename byte_type>
+	void ToBase64Transform<byte_type>::update_final(const transform_handler& handler)
+	{
+		this->final_into_buffer(handler);
 	}
 
 	template class FromBase64Transform<uint8_t>;
@@ -0,0 +1,339 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_BASE64_SIMD_H_
+#define _IOSTREAMS_BASE64_SIMD_H_
+
+#include "simd.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Vectorized base64 kernels (W. Mula, D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions"
+// and the AVX-512 VBMI follow-up). The kernels only touch [data, data + size) and only handle whole groups,
+// everything they leave is processed by the table driven code in base64.cpp.
+
+namespace iostreams
+{
+	namespace simd
+	{
+#ifdef IOSTREAMS_X86
+		// 6-bit indices to ASCII: the index range selects an offset that is added to the index, the last two
+		// characters are the only ones that differ between the alphabets
+		IOSTREAMS_TARGET("ssse3")
+		inline __m128i base64_encode_offsets(const char* alphabet)
+		{
+			return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+				'0' - 52, '0' - 52, '0' - 52, '0' - 52, static_cast<char>(alphabet[62] - 62), static_cast<char>(alphabet[63] - 63), 'A', 0, 0);
+		}
+
+		IOSTREAMS_TARGET("ssse3")
+		inline __m128i base64_encode_lookup(__m128i indices, __m128i offsets)
+		{
+			auto result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+			auto less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+			result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+			return _mm_add_epi8(_mm_shuffle_epi8(offsets, result), indices);
+		}
+
+		// spreads the bits of [b, a, c, b] 32-bit lanes into four 6-bit indices
+		IOSTREAMS_TARGET("ssse3")
+		inline __m128i base64_encode_split(__m128i input)
+		{
+			auto t0 = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+			auto t1 = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+			return _mm_or_si128(t0, t1);
+		}
+
+		IOSTREAMS_TARGET("ssse3")
+		inline size_t encode_base64_ssse3(const uint8_t* data, size_t size, char* out, const char* alphabet)
+		{
+			const auto offsets = base64_encode_offsets(alphabet);
+			const auto shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 16; consumed += 12, out += 16)
+			{
+				auto input = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed)), shuffle);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), base64_encode_lookup(base64_encode_split(input), offsets));
+			}
+
+			return consumed;
+		}
+
+		IOSTREAMS_TARGET("avx2")
+		inline size_t encode_base64_avx2(const uint8_t* data, size_t size, char* out, const char* alphabet)
+		{
+			const auto shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+				10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+			const auto offsets = _mm256_broadcastsi128_si256(base64_encode_offsets(alphabet));
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 32; consumed += 24, out += 32)
+			{
+				// 12 bytes per 128-bit lane
+				auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed));
+				auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed + 12));
+				auto input = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), shuffle);
+
+				auto t0 = _mm256_mulhi_epu16(_mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+				auto t1 = _mm256_mullo_epi16(_mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+				auto indices = _mm256_or_si256(t0, t1);
+
+				auto result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+				auto less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+				result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+				result = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, result), indices);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+			}
+
+			return consumed + encode_base64_ssse3(data + consumed, size - consumed, out, alphabet);
+		}
+
+#if defined (__GNUC__) && !defined (__clang__)
+		// GCC 12's VBMI intrinsics leave the pass-through operand uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+		IOSTREAMS_TARGET("avx512f,avx512bw,avx512vbmi")
+		inline size_t encode_base64_avx512(const uint8_t* data, size_t size, char* out, const char* alphabet)
+		{
+			const auto shuffle = _mm512_setr_epi32(0x01020001, 0x04050304, 0x07080607, 0x0a0b090a, 0x0d0e0c0d, 0x10110f10,
+				0x13141213, 0x16171516, 0x191a1819, 0x1c1d1b1c, 0x1f201e1f, 0x22232122, 0x25262425, 0x28292728, 0x2b2c2a2b, 0x2e2f2d2e);
+			const auto lookup = _mm512_loadu_si512(alphabet);
+			// bit offsets of the four indices inside each [b, a, c, b] lane
+			const auto shifts = _mm512_set1_epi64(0x3036242a1016040aLL);
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 64; consumed += 48, out += 64)
+			{
+				auto input = _mm512_permutexvar_epi8(shuffle, _mm512_loadu_si512(data + consumed));
+				auto indices = _mm512_multishift_epi64_epi8(shifts, input);
+				_mm512_storeu_si512(out, _mm512_permutexvar_epi8(indices, lookup));
+			}
+
+			return consumed + encode_base64_avx2(data + consumed, size - consumed, out, alphabet);
+		}
+#if defined (__GNUC__) && !defined (__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+		// maps the URL-safe '-' and '_' onto '+' and '/' and turns the standard ones into an invalid character,
+		// so the lookups below serve both alphabets
+		IOSTREAMS_TARGET("ssse3")
+		inline __m128i base64_from_url_safe(__m128i input)
+		{
+			auto minus = _mm_cmpeq_epi8(input, _mm_set1_epi8('-'));
+			auto underscore = _mm_cmpeq_epi8(input, _mm_set1_epi8('_'));
+			auto replaced = _mm_or_si128(_mm_or_si128(minus, underscore), _mm_or_si128(_mm_cmpeq_epi8(input, _mm_set1_epi8('+')), _mm_cmpeq_epi8(input, _mm_set1_epi8('/'))));
+
+			auto result = _mm_andnot_si128(replaced, input);
+			result = _mm_or_si128(result, _mm_and_si128(minus, _mm_set1_epi8('+')));
+			return _mm_or_si128(result, _mm_and_si128(underscore, _mm_set1_epi8('/')));
+		}
+
+		IOSTREAMS_TARGET("avx2")
+		inline __m256i base64_from_url_safe(__m256i input)
+		{
+			auto minus = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('-'));
+			auto underscore = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('_'));
+			auto replaced = _mm256_or_si256(_mm256_or_si256(minus, underscore), _mm256_or_si256(_mm256_cmpeq_epi8(input, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'))));
+
+			auto result = _mm256_andnot_si256(replaced, input);
+			result = _mm256_or_si256(result, _mm256_and_si256(minus, _mm256_set1_epi8('+')));
+			return _mm256_or_si256(result, _mm256_and_si256(underscore, _mm256_set1_epi8('/')));
+		}
+
+		// ASCII to 6-bit values, stops at the first block holding anything but the 64 alphabet characters
+		IOSTREAMS_TARGET("ssse3")
+		inline size_t decode_base64_ssse3(const char* data, size_t size, uint8_t* out, bool url_safe)
+		{
+			const auto shift_lut = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+			const auto mask_lut = _mm_setr_epi8(static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+				static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+				static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf0),
+				0x54, 0x50, 0x50, 0x50, 0x54);
+			const auto bit_lut = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+			const auto pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 16; consumed += 16, out += 12)
+			{
+				auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed));
+
+				if (url_safe)
+				{
+					input = base64_from_url_safe(input);
+				}
+
+				auto high_nibble = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0f));
+				auto low_nibble = _mm_and_si128(input, _mm_set1_epi8(0x0f));
+
+				auto valid = _mm_and_si128(_mm_shuffle_epi8(mask_lut, low_nibble), _mm_shuffle_epi8(bit_lut, high_nibble));
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128())) != 0)
+				{
+					break;
+				}
+
+				// '/' shares the high nibble with '+' but needs 16 instead of 19
+				auto shift = _mm_shuffle_epi8(shift_lut, high_nibble);
+				shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpeq_epi8(input, _mm_set1_epi8('/')), _mm_set1_epi8(-3)));
+				auto values = _mm_add_epi8(input, shift);
+
+				auto merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+				auto result = _mm_shuffle_epi8(merged, pack);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out), result);
+				auto tail = _mm_cvtsi128_si32(_mm_srli_si128(result, 8));
+				std::memcpy(out + 8, &tail, 4);
+			}
+
+			return consumed;
+		}
+
+		IOSTREAMS_TARGET("avx2")
+		inline size_t decode_base64_avx2(const char* data, size_t size, uint8_t* out, bool url_safe)
+		{
+			const auto shift_lut = _mm256_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+				0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+			const auto mask_lut = _mm256_setr_epi8(static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+				static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+				static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf0),
+				0x54, 0x50, 0x50, 0x50, 0x54,
+				static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+				static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+				static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf0),
+				0x54, 0x50, 0x50, 0x50, 0x54);
+			const auto bit_lut = _mm256_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0,
+				0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0);
+			const auto pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+			const auto lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 32; consumed += 32, out += 24)
+			{
+				auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + consumed));
+
+				if (url_safe)
+				{
+					input = base64_from_url_safe(input);
+				}
+
+				auto high_nibble = _mm256_and_si256(_mm256_srli_epi32(input, 4), _mm256_set1_epi8(0x0f));
+				auto low_nibble = _mm256_and_si256(input, _mm256_set1_epi8(0x0f));
+
+				auto valid = _mm256_and_si256(_mm256_shuffle_epi8(mask_lut, low_nibble), _mm256_shuffle_epi8(bit_lut, high_nibble));
+
+				if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(valid, _mm256_setzero_si256())) != 0)
+				{
+					break;
+				}
+
+				auto shift = _mm256_shuffle_epi8(shift_lut, high_nibble);
+				shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(input, _mm256_set1_epi8('/')), _mm256_set1_epi8(-3)));
+				auto values = _mm256_add_epi8(input, shift);
+
+				auto merged = _mm256_madd_epi16(_mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+				auto result = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(merged, pack), lanes);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(result));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(result, 1));
+			}
+
+			return consumed + decode_base64_ssse3(data + consumed, size - consumed, out, url_safe);
+		}
+
+#if defined (__GNUC__) && !defined (__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+		IOSTREAMS_TARGET("avx512f,avx512bw,avx512vbmi")
+		inline size_t decode_base64_avx512(const char* data, size_t size, uint8_t* out, const uint8_t* values, bool url_safe)
+		{
+			// byte 2, 1, 0 of every 32-bit lane
+			static const uint8_t pack[64]{
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 18, 17, 16, 22, 21, 20, 26, 25, 24, 30, 29, 28,
+				34, 33, 32, 38, 37, 36, 42, 41, 40, 46, 45, 44, 50, 49, 48, 54, 53, 52, 58, 57, 56, 62, 61, 60
+			};
+
+			// the ASCII half of the scalar table, characters outside the alphabet have the high bit set
+			const auto lookup_low = _mm512_loadu_si512(values);
+			const auto lookup_high = _mm512_loadu_si512(values + 64);
+			const auto pack_indices = _mm512_loadu_si512(pack);
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 64; consumed += 64, out += 48)
+			{
+				auto input = _mm512_loadu_si512(data + consumed);
+				auto sextets = _mm512_permutex2var_epi8(lookup_low, input, lookup_high);
+
+				// non-ASCII input or an invalid entry
+				if (_mm512_movepi8_mask(_mm512_or_si512(sextets, input)) != 0)
+				{
+					break;
+				}
+
+				auto merged = _mm512_madd_epi16(_mm512_maddubs_epi16(sextets, _mm512_set1_epi32(0x01400140)), _mm512_set1_epi32(0x00011000));
+				_mm512_mask_storeu_epi8(out, 0x0000FFFFFFFFFFFFULL, _mm512_permutexvar_epi8(pack_indices, merged));
+			}
+
+			return consumed + decode_base64_avx2(data + consumed, size - consumed, out, url_safe);
+		}
+#if defined (__GNUC__) && !defined (__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+		// encodes whole 3-byte groups from the bulk of the data with the 64-character alphabet, returns the number
+		// of consumed bytes
+		inline size_t encode_base64(const uint8_t* data, size_t size, char* out, const char* alphabet)
+		{
+#ifdef IOSTREAMS_X86
+			switch (level())
+			{
+			case Level::AVX512:
+				return encode_base64_avx512(data, size, out, alphabet);
+			case Level::AVX2:
+				return encode_base64_avx2(data, size, out, alphabet);
+			case Level::SSSE3:
+				return encode_base64_ssse3(data, size, out, alphabet);
+			case Level::NONE:
+				break;
+			}
+#endif
+			return 0;
+		}
+
+		// decodes whole 4-character groups, values maps every character to its 6-bit value and anything outside
+		// the alphabet to a value with the high bit set, returns the number of consumed characters
+		inline size_t decode_base64(const char* data, size_t size, uint8_t* out, const uint8_t* values)
+		{
+#ifdef IOSTREAMS_X86
+			auto url_safe = values[static_cast<uint8_t>('-')] < 0x80;
+
+			switch (level())
+			{
+			case Level::AVX512:
+				return decode_base64_avx512(data, size, out, values, url_safe);
+			case Level::AVX2:
+				return decode_base64_avx2(data, size, out, url_safe);
+			case Level::SSSE3:
+				return decode_base64_ssse3(data, size, out, url_safe);
+			case Level::NONE:
+				break;
+			}
+#endif
+			return 0;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -11,67 +11,99 @@
 
 #include "iostreams/transform/string_transform/hex.h"
 #include "iostreams/error.h"
+#include "hex_simd.h"
+#include <algorithm>
 #include <cassert>
 
 static constexpr char LOWERCASE_HEX_MAP[]{ '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
-//static constexpr char UPPERCASE_HEX_MAP[]{ '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-
-static constexpr char SPACE_CHAR{ ' ' };
-
-inline uint8_t HexToDigit(char ch)
-{
-    switch (ch)
-    {
-        case '0': return 0x0;
-        case '1': return 0x1;
-        case '2': return 0x2;
-        case '3': return 0x3;
-        case '4': return 0x4;
-        case '5': return 0x5;
-        case '6': return 0x6;
-        case '7': return 0x7;
-        case '8': return 0x8;
-        case '9': return 0x9;
-        case 'a': return 0xa;
-        case 'A': return 0xa;
-        case 'b': return 0xb;
-        case 'B': return 0xb;
-        case 'c': return 0xc;
-        case 'C': return 0xc;
-        case 'd': return 0xd;
-        case 'D': return 0xd;
-        case 'e': return 0xe;
-        case 'E': return 0xe;
-        case 'f': return 0xf;
-        case 'F': return 0xf;
-		default: throw iostreams::IOStreamsException(iostreams::errors::BAD_HEX_CHARACTER);
-    }
-}
+static constexpr char UPPERCASE_HEX_MAP[]{ '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+static constexpr uint8_t BADDIGIT{ 0xFF };
+static constexpr uint8_t SPACE{ 0xFE };
+
+// digit value of every character, SPACE for the whitespace that is skipped (the C locale set of isspace,
+// independent of the global locale), BADDIGIT for anything else
+static constexpr uint8_t HEX_DIGITS[256]{
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xfe, 0xfe, 0xfe, 0xfe, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
 
 namespace iostreams
 {
 	template<typename byte_type>
-	void ToHexTransform<byte_type>::update(const byte_type* data, size_type size, const transform_handler& handler)
+	TransformResult ToHexTransform<byte_type>::transform_into(const byte_type* data, size_type size, char* output, size_type capacity)
 	{
-		if (data != nullptr && size > 0)
+		if (data == nullptr)
 		{
-			while (size-- > 0)
-			{
-				if (this->buffer_index_ + 2 > this->buffer_.size())
-				{
-					this->flush(handler);
-				}
+			return TransformResult();
+		}
 
-				this->buffer_[this->buffer_index_++] = LOWERCASE_HEX_MAP[(*data >> 4) & 0x0F];
-				this->buffer_[this->buffer_index_++] = LOWERCASE_HEX_MAP[*data++ & 0x0F];
-			}
+		const char* digits = format_ == HexFormat::UPPERCASE ? UPPERCASE_HEX_MAP : LOWERCASE_HEX_MAP;
+		auto count = std::min(size, capacity / 2);
+		auto input = reinterpret_cast<const uint8_t*>(data);
+		auto i = simd::encode_hex(input, count, output, digits);
+
+		for (; i < count; ++i)
+		{
+			output[2 * i] = digits[input[i] >> 4];
+			output[2 * i + 1] = digits[input[i] & 0x0F];
 		}
+
+		return TransformResult{ count, count * 2 };
+	}
+
+	template<typename byte_type>
+	void ToHexTransform<byte_type>::update(const byte_type* data, size_type size, const transform_handler& handler)
+	{
+		this->update_into_buffer(data, size, handler);
 	}
 
 	template<typename byte_type>
 	void ToHexTransform<byte_type>::update_final(const transform_handler& handler)
 	{
-		this->flush(handler);
+		this->final_into_buffer(handler);
+	}
+
+	template<typename byte_type>
+	std::unique_ptr<StringTransform<byte_type, char>> ToHexTransform<byte_type>::fork() const
+	{
+		return std::unique_ptr<StringTransform<byte_type, char>>(new ToHexTransform(this->buffer_.size(), format_));
+	}
+
+	template<typename byte_type>
+	constexpr uint64_t FromHexTransform<byte_type>::NO_ERROR_OFFSET;
+
+	template<typename byte_type>
+	typename FromHexTransform<byte_type>::size_type FromHexTransform<byte_type>::significant_size(const char* data, size_type size) const
+	{
+		size_type skipped{ 0 };
+
+		for (size_type i = 0; i < size; ++i)
+		{
+			skipped += HEX_DIGITS[static_cast<uint8_t>(data[i])] == SPACE;
+		}
+
+		return size - skipped;
+	}
+
+	template<typename byte_type>
+	std::unique_ptr<StringTransform<char, byte_type>> FromHexTransform<byte_type>::fork() const
+	{
+		return std::unique_ptr<StringTransform<char, byte_type>>(new FromHexTransform(this->buffer_.size()));
 	}
 
 	template<typename byte_type>
@@ -82,93 +114,85 @@ namespace iostreams
 	}
 
 	template<typename byte_type>
-	void FromHexTransform<byte_type>::update(const char* data, size_type size, const transform_handler& handler)
+	TransformResult FromHexTransform<byte_type>::transform_into(const char* data, size_type size, byte_type* output, size_type capacity)
 	{
-		if (data != nullptr && size > 0)
+		TransformResult result;
+
+		if (data == nullptr)
 		{
-			auto get_char = [&data, &size]() -> char
-			{
-				if (size == 0)
-				{
-					return SPACE_CHAR;
-				}
+			return result;
+		}
 
-				char byte{ *data++ };
-				--size;
+		while (result.consumed < size)
+		{
+			if (ch_ == 0)
+			{
+				// runs of digits without whitespace are decoded a vector at a time
+				auto pairs = std::min((size - result.consumed) / 2, capacity - result.produced);
+				auto consumed = simd::decode_hex(data + result.consumed, pairs * 2, reinterpret_cast<uint8_t*>(output + result.produced));
 
-				while (::isspace(byte) && size > 0)
+				if (consumed > 0)
 				{
-					byte = *data++;
-					--size;
+					result.consumed += consumed;
+					result.produced += consumed / 2;
+					offset_ += consumed;
+					continue;
 				}
+			}
 
-				return byte;
-			};
+			auto ch = data[result.consumed];
+			auto digit = HEX_DIGITS[static_cast<uint8_t>(ch)];
 
-			if (ch_ != 0)
+			if (digit != SPACE)
 			{
-				auto byte = get_char();
-
-				if (byte == SPACE_CHAR)
-				{
-					return;
-				}
-
-				if (this->buffer_index_ + 1 > this->buffer_.size())
+				if (digit == BADDIGIT)
 				{
-					this->flush(handler);
+					error_offset_ = offset_;
+					throw IOStreamsException(errors::BAD_HEX_CHARACTER);
 				}
 
-				this->buffer_[this->buffer_index_++] = (HexToDigit(ch_) << 4) | HexToDigit(byte);
-				ch_ = 0;
-			}
-
-			while (size >= 2)
-			{
-				auto byte1 = get_char();
-
-				if (byte1 == SPACE_CHAR)
+				if (ch_ == 0)
 				{
-					break;
+					ch_ = ch;
 				}
-
-				auto byte2 = get_char();
-
-				if (byte2 == SPACE_CHAR)
+				else
 				{
-					if (ch_ != 0)
-					{
-						byte2 = ch_;
-						ch_ = 0;
-					}
-					else
+					if (result.produced == capacity)
 					{
-						ch_ = byte1;
 						break;
 					}
-				}
 
-				if (this->buffer_index_ + 1 > this->buffer_.size())
-				{
-					this->flush(handler);
+					output[result.produced++] = (HEX_DIGITS[static_cast<uint8_t>(ch_)] << 4) | digit;
+					ch_ = 0;
 				}
-
-				this->buffer_[this->buffer_index_++] = (HexToDigit(byte1) << 4) | HexToDigit(byte2);
 			}
 
-			if (size != 0)
-			{
-				auto byte = get_char();
-				ch_ = byte == SPACE_CHAR ? 0 : byte;
-			}
+			++result.consumed;
+			++offset_;
 		}
+
+		return result;
 	}
 
 	template<typename byte_type>
-	void FromHexTransform<byte_type>::update_final(const transform_handler& handler)
+	typename FromHexTransform<byte_type>::size_type FromHexTransform<byte_type>::finish_into(byte_type*, size_type)
 	{
-		this->flush(handler);
 		ch_ = 0;
+		offset_ = 0;
+		error_offset_ = NO_ERROR_OFFSET;
+		return 0;
+	}
+
+	template<typename byte_type>
+	void FromHexTransform<byte_type>::update(const char* data, size_type size, const transform_handler& handler)
+	{
+		this->update_into_buffer(data, size, handler);
+	}
+
+	template<typename byte_type>
+	void FromHexTransform<byte_type>::update_final(const transform_handler& handler)
+	{
+		this->final_into_buffer(handler);
 	}
 
 	template class ToHexTransform<uint8_t>;
@@ -0,0 +1,176 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _IOSTREAMS_HEX_SIMD_H_
+#define _IOSTREAMS_HEX_SIMD_H_
+
+#include "simd.h"
+#include <cstddef>
+#include <cstdint>
+
+// Vectorized hex kernels. Both only handle whole vectors inside [data, data + size) and return how much they
+// consumed, the rest is left to the scalar code in hex.cpp.
+
+namespace iostreams
+{
+	namespace simd
+	{
+#ifdef IOSTREAMS_X86
+		IOSTREAMS_TARGET("ssse3")
+		inline size_t encode_hex_ssse3(const uint8_t* data, size_t size, char* out, const char* digits)
+		{
+			const auto lookup = _mm_loadu_si128(reinterpret_cast<const __m128i*>(digits));
+			const auto nibble = _mm_set1_epi8(0x0f);
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 16; consumed += 16, out += 32)
+			{
+				auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed));
+				auto high = _mm_shuffle_epi8(lookup, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+				auto low = _mm_shuffle_epi8(lookup, _mm_and_si128(input, nibble));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+			}
+
+			return consumed;
+		}
+
+		IOSTREAMS_TARGET("avx2")
+		inline size_t encode_hex_avx2(const uint8_t* data, size_t size, char* out, const char* digits)
+		{
+			const auto lookup = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(digits)));
+			const auto nibble = _mm256_set1_epi8(0x0f);
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 32; consumed += 32, out += 64)
+			{
+				auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + consumed));
+				auto high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+				auto low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(input, nibble));
+
+				// unpack works inside 128-bit lanes, so the halves come out as [0-7, 16-23] and [8-15, 24-31]
+				auto first = _mm256_unpacklo_epi8(high, low);
+				auto second = _mm256_unpackhi_epi8(high, low);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), _mm256_permute2x128_si256(first, second, 0x31));
+			}
+
+			return consumed + encode_hex_ssse3(data + consumed, size - consumed, out, digits);
+		}
+
+		// digit values of a vector of characters plus a mask of the characters that are not hex digits
+		IOSTREAMS_TARGET("ssse3")
+		inline __m128i hex_to_digits(__m128i input, __m128i& invalid)
+		{
+			auto digit = _mm_sub_epi8(input, _mm_set1_epi8('0'));
+			auto is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+			auto letter = _mm_sub_epi8(_mm_or_si128(input, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+			auto is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+			invalid = _mm_andnot_si128(_mm_or_si128(is_digit, is_letter), _mm_set1_epi8(-1));
+			return _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+		}
+
+		IOSTREAMS_TARGET("ssse3")
+		inline size_t decode_hex_ssse3(const char* data, size_t size, uint8_t* out)
+		{
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 16; consumed += 16, out += 8)
+			{
+				__m128i invalid;
+				auto digits = hex_to_digits(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + consumed)), invalid);
+
+				if (_mm_movemask_epi8(invalid) != 0)
+				{
+					break;
+				}
+
+				// high * 16 + low for every pair
+				auto bytes = _mm_maddubs_epi16(digits, _mm_set1_epi16(0x0110));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(bytes, bytes));
+			}
+
+			return consumed;
+		}
+
+		IOSTREAMS_TARGET("avx2")
+		inline size_t decode_hex_avx2(const char* data, size_t size, uint8_t* out)
+		{
+			size_t consumed{ 0 };
+
+			for (; size - consumed >= 32; consumed += 32, out += 16)
+			{
+				auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + consumed));
+
+				auto digit = _mm256_sub_epi8(input, _mm256_set1_epi8('0'));
+				auto is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+
+				auto letter = _mm256_sub_epi8(_mm256_or_si256(input, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+				auto is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+				if (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter))) != 0xFFFFFFFFu)
+				{
+					break;
+				}
+
+				auto digits = _mm256_or_si256(_mm256_and_si256(is_digit, digit), _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+				auto bytes = _mm256_maddubs_epi16(digits, _mm256_set1_epi16(0x0110));
+				auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(bytes, bytes), 0xD8);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+			}
+
+			return consumed + decode_hex_ssse3(data + consumed, size - consumed, out);
+		}
+#endif
+
+		// writes two characters per byte taken from the 16 digits, returns the number of consumed bytes
+		inline size_t encode_hex(const uint8_t* data, size_t size, char* out, const char* digits)
+		{
+#ifdef IOSTREAMS_X86
+			switch (level())
+			{
+			case Level::AVX512:
+			case Level::AVX2:
+				return encode_hex_avx2(data, size, out, digits);
+			case Level::SSSE3:
+				return encode_hex_ssse3(data, size, out, digits);
+			case Level::NONE:
+				break;
+			}
+#endif
+			return 0;
+		}
+
+		// decodes pairs of hex digits, stops at the first vector holding anything else and returns the number
+		// of consumed characters
+		inline size_t decode_hex(const char* data, size_t size, uint8_t* out)
+		{
+#ifdef IOSTREAMS_X86
+			switch (level())
+			{
+			case Level::AVX512:
+			case Level::AVX2:
+				return decode_hex_avx2(data, size, out);
+			case Level::SSSE3:
+				return decode_hex_ssse3(data, size, out);
+			case Level::NONE:
+				break;
+			}
+#endif
+			return 0;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
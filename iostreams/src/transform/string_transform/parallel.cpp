@@ -0,0 +1,174 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "iostreams/transform/string_transform/parallel.h"
+#include "iostreams/error.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+
+namespace iostreams
+{
+	template<typename source_type, typename destination_type>
+	void parallel_update(StringTransform<source_type, destination_type>& transformer, const source_type* data, size_t size,
+		const typename StringTransform<source_type, destination_type>::transform_handler& handler, const ParallelOptions& options)
+	{
+		using size_type = typename StringTransform<source_type, destination_type>::size_type;
+
+		auto& pool = ThreadPool::shared();
+		auto threads = options.threads != 0 ? static_cast<size_t>(options.threads) : pool.size() + 1;
+		auto count = std::min(threads, size / std::max<size_t>(options.chunk_size, 1));
+		auto unit = transformer.split_unit();
+
+		if (data == nullptr || unit == 0 || count < 2)
+		{
+			transformer.update(data, size, handler);
+			return;
+		}
+
+		auto is_significant = [&transformer, data](size_t position)
+		{
+			return transformer.significant_size(data + position, 1) != 0;
+		};
+
+		// even cuts first, counting the significant elements of every piece
+		std::vector<size_t> bounds(count + 1);
+		std::vector<size_type> counts(count);
+
+		for (size_t i = 0; i <= count; ++i)
+		{
+			bounds[i] = size / count * i;
+		}
+
+		bounds[count] = size;
+
+		pool.run(count, [&](size_t i)
+		{
+			counts[i] = transformer.significant_size(data + bounds[i], bounds[i + 1] - bounds[i]);
+		});
+
+		// then every cut moves forward to the next block boundary
+		std::vector<size_t> cuts{ 0 };
+		auto seen = transformer.split_phase();
+
+		for (size_t i = 1; i < count; ++i)
+		{
+			seen += counts[i - 1];
+			auto position = bounds[i];
+
+			for (auto missing = (unit - seen % unit) % unit; missing > 0 && position < size; ++position)
+			{
+				missing -= is_significant(position) ? 1 : 0;
+			}
+
+			if (position > cuts.back())
+			{
+				cuts.push_back(position);
+			}
+		}
+
+		// the incomplete last block and anything skipped after it stay with transformer
+		seen += counts[count - 1];
+		auto end = size;
+
+		for (auto extra = seen % unit; end > 0 && (extra > 0 || !is_significant(end - 1)); --end)
+		{
+			extra -= is_significant(end - 1) ? 1 : 0;
+		}
+
+		while (!cuts.empty() && cuts.back() >= end)
+		{
+			cuts.pop_back();
+		}
+
+		cuts.push_back(end);
+		auto pieces = cuts.size() - 1;
+
+		if (pieces < 2)
+		{
+			transformer.update(data, size, handler);
+			return;
+		}
+
+		std::vector<std::unique_ptr<StringTransform<source_type, destination_type>>> forks(pieces);
+		std::vector<size_t> offsets(pieces + 1);
+		// a block of slack for what a piece may add on its own, like the line break in front of its first line
+		auto slack = transformer.required_size(unit);
+
+		for (size_t i = 1; i < pieces; ++i)
+		{
+			forks[i] = transformer.fork();
+
+			if (forks[i] == nullptr)
+			{
+				transformer.update(data, size, handler);
+				return;
+			}
+
+			offsets[i + 1] = offsets[i] + transformer.required_size(cuts[i + 1] - cuts[i]) + slack;
+		}
+
+		std::vector<destination_type> output(offsets[pieces]);
+		std::vector<size_t> produced(pieces);
+
+		pool.run(pieces, [&](size_t i)
+		{
+			if (i == 0)
+			{
+				transformer.update(data, cuts[1], handler);
+				return;
+			}
+
+			auto slice = output.data() + offsets[i];
+			auto capacity = offsets[i + 1] - offsets[i];
+			auto& slice_size = produced[i];
+			auto& fork = *forks[i];
+
+			if (fork.supports_transform_into())
+			{
+				auto result = fork.transform_into(data + cuts[i], cuts[i + 1] - cuts[i], slice, capacity);
+				THROW_IF(result.consumed != cuts[i + 1] - cuts[i], IOStreamsException(errors::BUFFER_TOO_SMALL));
+				slice_size = result.produced;
+				slice_size += fork.finish_into(slice + slice_size, capacity - slice_size);
+				return;
+			}
+
+			auto write_slice = [slice, capacity, &slice_size](const destination_type* data, size_type size)
+			{
+				THROW_IF(slice_size + size > capacity, IOStreamsException(errors::BUFFER_TOO_SMALL));
+				std::memcpy(slice + slice_size, data, size * sizeof(destination_type));
+				slice_size += size;
+			};
+
+			fork.update_with(data + cuts[i], cuts[i + 1] - cuts[i], write_slice);
+			fork.update_final_with(write_slice);
+		});
+
+		transformer.flush(handler);
+
+		for (size_t i = 1; i < pieces; ++i)
+		{
+			if (produced[i] > 0 && handler != nullptr)
+			{
+				handler(output.data() + offsets[i], produced[i]);
+			}
+		}
+
+		if (end < size)
+		{
+			transformer.update(data + end, size - end, handler);
+		}
+	}
+
+	template void parallel_update<uint8_t, char>(StringTransform<uint8_t, char>&, const uint8_t*, size_t, const StringTransform<uint8_t, char>::transform_handler&, const ParallelOptions&);
+	template void parallel_update<char, char>(StringTransform<char, char>&, const char*, size_t, const StringTransform<char, char>::transform_handler&, const ParallelOptions&);
+	template void parallel_update<char, uint8_t>(StringTransform<char, uint8_t>&, const char*, size_t, const StringTransform<char, uint8_t>::transform_handler&, const ParallelOptions&);
+}
\ No newline at end of file
@@ -13,12 +13,22 @@
 
 #include "iostreams/file.h"
 #include "liberror/exception.h"
+#include "flush_scheduler.h"
 #include <unistd.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <cstdlib>
+#include <cstring>
+#include <sys/uio.h>
 
 #ifdef __MACH__
 	#define lseek64 lseek
 	#define ftruncate64 ftruncate
+	#define pread64 pread
+	#define pwrite64 pwrite
+	#define preadv64 preadv
+	#define pwritev64 pwritev
+	#define fdatasync fsync
 #endif
 
 namespace iostreams
@@ -29,6 +39,11 @@ namespace iostreams
 	private:
 		int fd_{ -1 };
 		bool auto_flush_{ false };
+		bool cache_state_{ false };
+		uint64_t position_{ 0 };
+		uint64_t size_{ 0 };
+		bool direct_io_{ false };
+		std::unique_ptr<FlushScheduler> flush_scheduler_;
 
 	public:
 		using size_type = typename FileStream<byte_type>::size_type;
@@ -42,6 +57,11 @@ namespace iostreams
 		FileImpl(FileImpl&& stream)
 			: fd_(stream.fd_)
 			, auto_flush_(stream.auto_flush_)
+			, cache_state_(stream.cache_state_)
+			, position_(stream.position_)
+			, size_(stream.size_)
+			, direct_io_(stream.direct_io_)
+			, flush_scheduler_(std::move(stream.flush_scheduler_))
 		{
 			stream.fd_ = -1;
 		}
@@ -50,6 +70,11 @@ namespace iostreams
 		{
 			fd_ = stream.fd_;
 			auto_flush_ = stream.auto_flush_;
+			cache_state_ = stream.cache_state_;
+			position_ = stream.position_;
+			size_ = stream.size_;
+			direct_io_ = stream.direct_io_;
+			flush_scheduler_ = std::move(stream.flush_scheduler_);
 			stream.fd_ = -1;
 			return *this;
 		}
@@ -59,7 +84,12 @@ namespace iostreams
 
 		~FileImpl()
 		{
-			close();
+			try
+			{
+				close();
+			}
+			catch (...)
+			{}
 		}
 
 		static std::unique_ptr<FileImpl> create(FILE* file)
@@ -125,16 +155,276 @@ namespace iostreams
 				? ::open(path, static_cast<int>(flags)) 
 				: ::open(path, static_cast<int>(flags), open_mode);
 			THROW_IF(fd == -1, POSIX_ERROR("open"));
+			auto impl = std::make_unique<FileImpl>(fd);
+
+#ifdef O_DIRECT
+			if ((flags & O_DIRECT) != 0)
+			{
+				impl->set_cache_state(true);
+				impl->direct_io_ = true;
+			}
+#endif
+
+			return impl;
+		}
+
+		static std::unique_ptr<FileImpl> temporary(const char* directory)
+		{
+			if (directory == nullptr)
+			{
+				directory = ::getenv("TMPDIR");
+
+				if (directory == nullptr || *directory == '\0')
+				{
+					directory = "/tmp";
+				}
+			}
+
+			int fd{ -1 };
+
+#ifdef O_TMPFILE
+			fd = ::open(directory, O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+			THROW_IF(fd == -1 && errno != EOPNOTSUPP && errno != EISDIR && errno != EINVAL, POSIX_ERROR("open"));
+#endif
+
+			if (fd == -1)
+			{
+				std::string path(directory);
+				path.append("/iostreams.XXXXXX");
+
+				fd = ::mkstemp(&path[0]);
+				THROW_IF(fd == -1, POSIX_ERROR("mkstemp"));
+
+				if (::unlink(path.c_str()) == -1)
+				{
+					auto err = errno;
+					::close(fd);
+					throw liberror::PosixException(err, "unlink");
+				}
+			}
+
 			return std::make_unique<FileImpl>(fd);
 		}
 
+		int native_handle() const { return fd_; }
+
 		bool auto_flush() const { return auto_flush_; }
 		void set_auto_flush(bool val) { auto_flush_ = val; }
 
+		FlushPolicy flush_policy() const
+		{
+			return flush_scheduler_ ? flush_scheduler_->policy() : FlushPolicy();
+		}
+
+		void set_flush_policy(const FlushPolicy& policy)
+		{
+			if (!flush_scheduler_)
+			{
+				auto fd = fd_;
+				flush_scheduler_ = std::make_unique<FlushScheduler>([fd]()
+				{
+					THROW_IF(::fdatasync(fd) == -1, POSIX_ERROR("fdatasync"));
+				});
+			}
+
+			flush_scheduler_->set_policy(policy);
+		}
+
+		void flush()
+		{
+			if (flush_scheduler_)
+			{
+				flush_scheduler_->flush();
+			}
+			else
+			{
+				THROW_IF(::fdatasync(fd_) == -1, POSIX_ERROR("fdatasync"));
+			}
+		}
+
+		void sync()
+		{
+			auto fd = fd_;
+			auto sync = [fd]()
+			{
+				THROW_IF(::fsync(fd) == -1, POSIX_ERROR("fsync"));
+			};
+
+			if (flush_scheduler_)
+			{
+				flush_scheduler_->flush(sync);
+			}
+			else
+			{
+				sync();
+			}
+		}
+
+		bool cache_state() const { return cache_state_; }
+
+		void set_cache_state(bool val)
+		{
+			THROW_IF(!val && direct_io_, IOStreamsException(errors::DIRECT_IO_REQUIRES_CACHE));
+
+			if (val != cache_state_)
+			{
+				if (val)
+				{
+					position_ = file_position();
+					size_ = file_size();
+				}
+				else
+				{
+					// in cached mode reads and writes are positional, so the descriptor offset is stale
+					THROW_IF(::lseek64(fd_, position_, SEEK_SET) == -1, POSIX_ERROR("lseek64"));
+				}
+
+				cache_state_ = val;
+			}
+		}
+
+		bool direct_io() const { return direct_io_; }
+
+		void set_direct_io(bool val)
+		{
+			if (val != direct_io_)
+			{
+#ifdef O_DIRECT
+				auto flags = ::fcntl(fd_, F_GETFL);
+				THROW_IF(flags == -1, POSIX_ERROR("fcntl"));
+				THROW_IF(::fcntl(fd_, F_SETFL, val ? flags | O_DIRECT : flags & ~O_DIRECT) == -1, POSIX_ERROR("fcntl"));
+#elif defined (F_NOCACHE)
+				THROW_IF(::fcntl(fd_, F_NOCACHE, val ? 1 : 0) == -1, POSIX_ERROR("fcntl"));
+#endif
+
+				if (val)
+				{
+					set_cache_state(true);
+				}
+				else
+				{
+					truncate_padding();
+				}
+
+				direct_io_ = val;
+			}
+		}
+
+		void advise(FileAccessPattern pattern, size_type offset, size_type length)
+		{
+#if defined (__linux__)
+			if (pattern == FileAccessPattern::WILL_NEED)
+			{
+				auto count = length != 0 ? length : (offset < size() ? size() - offset : 0);
+
+				if (::readahead(fd_, static_cast<off64_t>(offset), static_cast<size_t>(count)) == 0)
+				{
+					return;
+				}
+			}
+
+			int advice{ POSIX_FADV_NORMAL };
+
+			switch (pattern)
+			{
+			case FileAccessPattern::NORMAL:
+				advice = POSIX_FADV_NORMAL;
+				break;
+			case FileAccessPattern::SEQUENTIAL:
+				advice = POSIX_FADV_SEQUENTIAL;
+				break;
+			case FileAccessPattern::RANDOM:
+				advice = POSIX_FADV_RANDOM;
+				break;
+			case FileAccessPattern::WILL_NEED:
+				advice = POSIX_FADV_WILLNEED;
+				break;
+			case FileAccessPattern::DONT_NEED:
+				advice = POSIX_FADV_DONTNEED;
+				break;
+			}
+
+			auto ret = ::posix_fadvise64(fd_, static_cast<off64_t>(offset), static_cast<off64_t>(length), advice);
+			THROW_IF(ret != 0, liberror::PosixException(ret, "posix_fadvise64"));
+#elif defined (__APPLE__)
+			if (pattern == FileAccessPattern::SEQUENTIAL || pattern == FileAccessPattern::RANDOM)
+			{
+				THROW_IF(::fcntl(fd_, F_RDAHEAD, pattern == FileAccessPattern::SEQUENTIAL ? 1 : 0) == -1, POSIX_ERROR("fcntl"));
+			}
+			else if (pattern == FileAccessPattern::WILL_NEED)
+			{
+				auto count = length != 0 ? length : (offset < size() ? size() - offset : 0);
+				radvisory advisory{ static_cast<off_t>(offset), static_cast<int>(std::min<size_type>(count, INT_MAX)) };
+				THROW_IF(::fcntl(fd_, F_RDADVISE, &advisory) == -1, POSIX_ERROR("fcntl"));
+			}
+#endif
+		}
+
+		void reserve(size_type new_size)
+		{
+			auto file_size = size();
+
+			if (new_size > file_size)
+			{
+#if defined (__linux__)
+				allocate(FALLOC_FL_KEEP_SIZE, file_size, new_size - file_size);
+#elif defined (__APPLE__)
+				fstore_t store{ F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(new_size - file_size), 0 };
+				THROW_IF(::fcntl(fd_, F_PREALLOCATE, &store) == -1, POSIX_ERROR("fcntl"));
+#endif
+			}
+		}
+
+		void refresh()
+		{
+			if (direct_io_)
+			{
+				// the file on disk is padded to whole blocks, only a shrink is taken from it
+				size_ = std::min(size_, file_size());
+			}
+			else if (cache_state_)
+			{
+				size_ = file_size();
+			}
+
+			if (cache_state_)
+			{
+				// the file may have been truncated through another handle
+				if (position_ > size_)
+				{
+					position_ = size_;
+				}
+			}
+		}
+
 		void close()
 		{
 			if (fd_ != -1)
 			{
+				if (direct_io_ || flush_scheduler_)
+				{
+					try
+					{
+						if (direct_io_)
+						{
+							truncate_padding();
+						}
+
+						if (flush_scheduler_ && flush_scheduler_->shutdown() != 0)
+						{
+							THROW_IF(::fdatasync(fd_) == -1, POSIX_ERROR("fdatasync"));
+						}
+					}
+					catch (...)
+					{
+						flush_scheduler_.reset();
+						::close(fd_);
+						fd_ = -1;
+						throw;
+					}
+				}
+
+				flush_scheduler_.reset();
 				::close(fd_);
 				fd_ = -1;
 			}
@@ -142,20 +432,26 @@ namespace iostreams
 
 		size_type size() const
 		{
-			struct stat stat_buffer;
-			THROW_IF(::fstat(fd_, &stat_buffer) != 0, POSIX_ERROR("fstat"));
-			return static_cast<size_type>(stat_buffer.st_size);
+			return cache_state_ ? size_ : file_size();
 		}
 
 		size_type tell() const
 		{
-			return static_cast<size_type>(::lseek64(fd_, 0, SEEK_CUR));
+			return cache_state_ ? position_ : file_position();
 		}
 
 		void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg)
 		{
-			FileStream<byte_type>::check_seek_range(off, way, tell(), size());
-			THROW_IF(::lseek64(fd_, off, way) == -1, POSIX_ERROR("lseek64"));
+			auto position = FileStream<byte_type>::check_seek_range(off, way, tell(), size());
+
+			if (cache_state_)
+			{
+				position_ = position;
+			}
+			else
+			{
+				THROW_IF(::lseek64(fd_, off, way) == -1, POSIX_ERROR("lseek64"));
+			}
 		}
 
 		void resize(size_type new_size)
@@ -164,10 +460,44 @@ namespace iostreams
 
 			if (file_size != new_size)
 			{
-				if (file_size > new_size)
+				// fallocate extends the file with allocated zeroed blocks instead of leaving a hole
+				if (new_size > file_size && allocate(0, file_size, new_size - file_size))
+				{
+					if (cache_state_)
+					{
+						size_ = new_size;
+					}
+				}
+				else if (direct_io_)
+				{
+					THROW_IF(::ftruncate64(fd_, new_size) != 0, POSIX_ERROR("ftruncate64"));
+
+					if (new_size < file_size)
+					{
+						position_ = new_size;
+					}
+
+					size_ = new_size;
+				}
+				else if (file_size > new_size)
 				{
 					THROW_IF(::ftruncate64(fd_, new_size) != 0, POSIX_ERROR("ftruncate64"));
-					THROW_IF(::lseek64(fd_, 0, std::ios_base::end) == -1, POSIX_ERROR("lseek64"));
+
+					if (cache_state_)
+					{
+						position_ = new_size;
+						size_ = new_size;
+					}
+					else
+					{
+						THROW_IF(::lseek64(fd_, 0, std::ios_base::end) == -1, POSIX_ERROR("lseek64"));
+					}
+				}
+				else if (cache_state_)
+				{
+					byte_type byte{ 0 };
+					write_at(new_size - 1, &byte, 1);
+					size_ = new_size;
 				}
 				else
 				{
@@ -184,6 +514,13 @@ namespace iostreams
 
 		count_type read(byte_type* buffer, count_type count)
 		{
+			if (cache_state_)
+			{
+				auto read_bytes = read_at(position_, buffer, count);
+				position_ += read_bytes;
+				return read_bytes;
+			}
+
 			count_type read_bytes{ 0 };
 			ssize_t ret;
 
@@ -206,30 +543,449 @@ namespace iostreams
 
 		count_type write(const byte_type* data, count_type count)
 		{
+			count_type written_bytes{ 0 };
+
+			if (cache_state_)
+			{
+				written_bytes = write_at(position_, data, count);
+				position_ += written_bytes;
+
+				if (position_ > size_)
+				{
+					size_ = position_;
+				}
+			}
+			else
+			{
+				ssize_t ret;
+
+				while (count != 0 && (ret = ::write(fd_, data, count)) != 0)
+				{
+					if (ret == -1)
+					{
+						THROW_IF(errno != EINTR, POSIX_ERROR("write"));
+					}
+					else
+					{
+						written_bytes += ret;
+						count -= ret;
+						data += ret;
+					}
+				}
+			}
+
+			commit(written_bytes);
+
+			return written_bytes;
+		}
+
+		count_type readv(const Buffer* buffers, count_type count)
+		{
+			if (direct_io_)
+			{
+				count_type read_bytes{ 0 };
+
+				for (count_type i = 0; i < count; ++i)
+				{
+					auto bytes = read(buffers[i].data, buffers[i].size);
+					read_bytes += bytes;
+
+					if (bytes < buffers[i].size)
+					{
+						break;
+					}
+				}
+
+				return read_bytes;
+			}
+
+			return transfer(buffers, count, "readv", [this](const iovec* iov, int iovcnt)
+			{
+				return cache_state_ ? ::preadv64(fd_, iov, iovcnt, position_) : ::readv(fd_, iov, iovcnt);
+			});
+		}
+
+		count_type writev(const ConstBuffer* buffers, count_type count)
+		{
+			if (direct_io_)
+			{
+				count_type written_bytes{ 0 };
+
+				for (count_type i = 0; i < count; ++i)
+				{
+					written_bytes += write(buffers[i].data, buffers[i].size);
+				}
+
+				return written_bytes;
+			}
+
+			auto written_bytes = transfer(buffers, count, "writev", [this](const iovec* iov, int iovcnt)
+			{
+				return cache_state_ ? ::pwritev64(fd_, iov, iovcnt, position_) : ::writev(fd_, iov, iovcnt);
+			});
+
+			if (cache_state_ && position_ > size_)
+			{
+				size_ = position_;
+			}
+
+			commit(written_bytes);
+
+			return written_bytes;
+		}
+
+		count_type pread(size_type offset, byte_type* buffer, count_type count) const
+		{
+			return read_at(offset, buffer, count);
+		}
+
+		count_type pwrite(size_type offset, const byte_type* data, count_type count)
+		{
+			auto written_bytes = write_at(offset, data, count);
+
+			if (cache_state_ && offset + written_bytes > size_)
+			{
+				size_ = offset + written_bytes;
+			}
+
+			commit(written_bytes);
+
+			return written_bytes;
+		}
+
+	private:
+		size_type file_size() const
+		{
+			struct stat stat_buffer;
+			THROW_IF(::fstat(fd_, &stat_buffer) != 0, POSIX_ERROR("fstat"));
+			return static_cast<size_type>(stat_buffer.st_size);
+		}
+
+		// auto_flush keeps the fsync per write, otherwise the flush policy decides when to sync
+		void commit(count_type written_bytes)
+		{
+			if (auto_flush_)
+			{
+				THROW_IF(::fsync(fd_) == -1, POSIX_ERROR("fsync"));
+			}
+			else if (flush_scheduler_)
+			{
+				flush_scheduler_->on_write(written_bytes);
+			}
+		}
+
+		// returns false when the filesystem cannot preallocate
+		bool allocate(int mode, size_type offset, size_type length)
+		{
+#if defined (__linux__)
+			while (::fallocate64(fd_, mode, static_cast<off64_t>(offset), static_cast<off64_t>(length)) == -1)
+			{
+				if (errno == EOPNOTSUPP || errno == ENOSYS)
+				{
+					return false;
+				}
+
+				THROW_IF(errno != EINTR, POSIX_ERROR("fallocate64"));
+			}
+
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		size_type file_position() const
+		{
+			return static_cast<size_type>(::lseek64(fd_, 0, SEEK_CUR));
+		}
+
+		count_type read_at(size_type offset, byte_type* buffer, count_type count) const
+		{
+			if (direct_io_)
+			{
+				return direct_read_at(offset, buffer, count);
+			}
+
+			count_type read_bytes{ 0 };
+			ssize_t ret;
+
+			while (count != 0 && (ret = ::pread64(fd_, buffer, count, offset)) != 0)
+			{
+				if (ret == -1)
+				{
+					THROW_IF(errno != EINTR, POSIX_ERROR("pread64"));
+				}
+				else
+				{
+					count -= ret;
+					read_bytes += ret;
+					buffer += ret;
+					offset += ret;
+				}
+			}
+
+			return read_bytes;
+		}
+
+		// issues as few vectored calls as possible, resuming after partial transfers
+		template<typename buffer_type, typename io_type>
+		count_type transfer(const buffer_type* buffers, count_type count, const char* context, io_type io)
+		{
+			static constexpr count_type MAX_IOV_COUNT{ IOV_MAX };
+
+			std::vector<iovec> iov;
+			iov.reserve(std::min(count, MAX_IOV_COUNT));
+
+			count_type transferred_bytes{ 0 };
+			count_type index{ 0 };
+			count_type skip{ 0 };
+
+			while (index < count)
+			{
+				iov.clear();
+
+				for (auto i = index; i < count && iov.size() < MAX_IOV_COUNT; ++i)
+				{
+					auto offset = i == index ? skip : 0;
+					iov.push_back({ const_cast<byte_type*>(buffers[i].data) + offset, buffers[i].size - offset });
+				}
+
+				auto ret = io(iov.data(), static_cast<int>(iov.size()));
+
+				if (ret == -1)
+				{
+					THROW_IF(errno != EINTR, POSIX_ERROR(context));
+					continue;
+				}
+
+				if (ret == 0 && iov.front().iov_len != 0)
+				{
+					break;
+				}
+
+				auto left = static_cast<count_type>(ret);
+				transferred_bytes += left;
+
+				if (cache_state_)
+				{
+					position_ += left;
+				}
+
+				while (index < count && left >= buffers[index].size - skip)
+				{
+					left -= buffers[index].size - skip;
+					skip = 0;
+					++index;
+				}
+
+				skip += left;
+			}
+
+			return transferred_bytes;
+		}
+
+		count_type write_at(size_type offset, const byte_type* data, count_type count)
+		{
+			if (direct_io_)
+			{
+				return direct_write_at(offset, data, count);
+			}
+
 			count_type written_bytes{ 0 };
 			ssize_t ret;
 
-			while (count != 0 && (ret = ::write(fd_, data, count)) != 0)
+			while (count != 0 && (ret = ::pwrite64(fd_, data, count, offset)) != 0)
 			{
 				if (ret == -1)
 				{
-					THROW_IF(errno != EINTR, POSIX_ERROR("write"));
+					THROW_IF(errno != EINTR, POSIX_ERROR("pwrite64"));
 				}
 				else
 				{
 					written_bytes += ret;
 					count -= ret;
 					data += ret;
+					offset += ret;
 				}
 			}
 
-			if (auto_flush_)
+			return written_bytes;
+		}
+
+		// direct I/O transfers whole aligned blocks; unaligned requests are staged through a bounce buffer
+		// allocated per call, which keeps pread safe for concurrent use
+		static constexpr size_type DIRECT_IO_ALIGNMENT{ 4096 };
+		static constexpr size_type DIRECT_IO_BUFFER_SIZE{ 1024 * 1024 };
+
+		using aligned_buffer = std::unique_ptr<uint8_t, decltype(&::free)>;
+
+		static bool is_aligned(size_type offset, const void* data, count_type count)
+		{
+			return offset % DIRECT_IO_ALIGNMENT == 0
+				&& count % DIRECT_IO_ALIGNMENT == 0
+				&& reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT == 0;
+		}
+
+		static aligned_buffer allocate_aligned(size_type skip, count_type count)
+		{
+			auto size = std::min((skip + count + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT, DIRECT_IO_BUFFER_SIZE);
+			void* buffer{ nullptr };
+			auto ret = ::posix_memalign(&buffer, static_cast<size_t>(DIRECT_IO_ALIGNMENT), static_cast<size_t>(size));
+			THROW_IF(ret != 0, liberror::PosixException(ret, "posix_memalign"));
+			return aligned_buffer(static_cast<uint8_t*>(buffer), ::free);
+		}
+
+		count_type pread_blocks(size_type offset, void* buffer, count_type count) const
+		{
+			count_type read_bytes{ 0 };
+			ssize_t ret;
+
+			while (count != 0 && (ret = ::pread64(fd_, static_cast<uint8_t*>(buffer) + read_bytes, count, offset + read_bytes)) != 0)
 			{
-				THROW_IF(::fsync(fd_) == -1, POSIX_ERROR("fsync"));
+				if (ret == -1)
+				{
+					THROW_IF(errno != EINTR, POSIX_ERROR("pread64"));
+				}
+				else
+				{
+					count -= ret;
+					read_bytes += ret;
+				}
 			}
 
-			return written_bytes;
+			return read_bytes;
+		}
+
+		void pwrite_blocks(size_type offset, const void* data, count_type count)
+		{
+			count_type written_bytes{ 0 };
+
+			while (written_bytes != count)
+			{
+				auto ret = ::pwrite64(fd_, static_cast<const uint8_t*>(data) + written_bytes, count - written_bytes, offset + written_bytes);
+
+				if (ret == -1)
+				{
+					THROW_IF(errno != EINTR, POSIX_ERROR("pwrite64"));
+				}
+				else
+				{
+					written_bytes += ret;
+				}
+			}
+		}
+
+		count_type direct_read_at(size_type offset, byte_type* buffer, count_type count) const
+		{
+			count = offset < size_ ? static_cast<count_type>(std::min<size_type>(count, size_ - offset)) : 0;
+
+			if (count == 0)
+			{
+				return 0;
+			}
+
+			if (is_aligned(offset, buffer, count))
+			{
+				return pread_blocks(offset, buffer, count);
+			}
+
+			auto bounce = allocate_aligned(offset % DIRECT_IO_ALIGNMENT, count);
+			count_type read_bytes{ 0 };
+
+			while (count > 0)
+			{
+				auto skip = offset % DIRECT_IO_ALIGNMENT;
+				auto length = static_cast<count_type>(std::min((skip + count + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT, DIRECT_IO_BUFFER_SIZE));
+				auto ret = pread_blocks(offset - skip, bounce.get(), length);
+
+				if (ret <= skip)
+				{
+					break;
+				}
+
+				auto processed = std::min(count, static_cast<count_type>(ret - skip));
+				std::memcpy(buffer, bounce.get() + skip, processed);
+				buffer += processed;
+				offset += processed;
+				count -= processed;
+				read_bytes += processed;
+
+				if (ret < length)
+				{
+					break;
+				}
+			}
+
+			return read_bytes;
+		}
+
+		count_type direct_write_at(size_type offset, const byte_type* data, count_type count)
+		{
+			if (count == 0)
+			{
+				return 0;
+			}
+
+			if (is_aligned(offset, data, count))
+			{
+				pwrite_blocks(offset, data, count);
+			}
+			else
+			{
+				auto bounce = allocate_aligned(offset % DIRECT_IO_ALIGNMENT, count);
+				auto left = count;
+
+				while (left > 0)
+				{
+					auto skip = offset % DIRECT_IO_ALIGNMENT;
+					auto block_offset = offset - skip;
+					auto length = static_cast<count_type>(std::min((skip + left + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT, DIRECT_IO_BUFFER_SIZE));
+					auto processed = std::min(left, static_cast<count_type>(length - skip));
+					auto tail_offset = block_offset + length - DIRECT_IO_ALIGNMENT;
+
+					// read-modify-write of partially covered head and tail blocks that hold existing data
+					if (skip != 0)
+					{
+						load_block(block_offset, bounce.get());
+					}
+
+					if ((skip + processed) % DIRECT_IO_ALIGNMENT != 0 && (tail_offset != block_offset || skip == 0))
+					{
+						load_block(tail_offset, bounce.get() + length - DIRECT_IO_ALIGNMENT);
+					}
+
+					std::memcpy(bounce.get() + skip, data, processed);
+					pwrite_blocks(block_offset, bounce.get(), length);
+
+					data += processed;
+					offset += processed;
+					left -= processed;
+				}
+			}
+
+			return count;
+		}
+
+		void load_block(size_type block_offset, uint8_t* block) const
+		{
+			auto ret = block_offset < size_ ? pread_blocks(block_offset, block, static_cast<count_type>(DIRECT_IO_ALIGNMENT)) : 0;
+			std::memset(block + ret, 0, static_cast<size_t>(DIRECT_IO_ALIGNMENT - ret));
+		}
+
+		// whole-block writes may leave the file longer than its logical size
+		void truncate_padding()
+		{
+			if (file_size() != size_)
+			{
+				THROW_IF(::ftruncate64(fd_, size_) != 0, POSIX_ERROR("ftruncate64"));
+			}
 		}
 	};
+
+	template<typename byte_type>
+	constexpr typename FileStream<byte_type>::size_type FileStream<byte_type>::FileImpl::DIRECT_IO_ALIGNMENT;
+
+	template<typename byte_type>
+	constexpr typename FileStream<byte_type>::size_type FileStream<byte_type>::FileImpl::DIRECT_IO_BUFFER_SIZE;
 }
 #endif
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include "iostreams/file.h"
 #include "iostreams/error.h"
 #include "babel/encoding.h"
+#include "flush_scheduler.h"
 #include <windows.h>
 #include <io.h>
 
@@ -24,19 +25,31 @@
 	 private:
 		 HANDLE handle_{ INVALID_HANDLE_VALUE };
 		 bool auto_flush_{ false };
+		 bool cache_state_{ false };
+		 uint64_t position_{ 0 };
+		 uint64_t size_{ 0 };
+		 std::unique_ptr<FlushScheduler> flush_scheduler_;
 
 	 public:
 		 using size_type = typename FileStream<byte_type>::size_type;
 		 using count_type = typename FileStream<byte_type>::count_type;
 		 using off_type = typename FileStream<byte_type>::off_type;
 
+		 // reads and writes pass their offset in an OVERLAPPED, the position is kept here and the file pointer
+		 // of the handle is left alone, so concurrent pread and pwrite do not race on it
 		 FileImpl(HANDLE handle)
 			 : handle_(handle)
-		 {}
+		 {
+			 position_ = file_position();
+		 }
 
 		 FileImpl(FileImpl&& stream)
 			 : handle_(stream.handle_)
 			 , auto_flush_(stream.auto_flush_)
+			 , cache_state_(stream.cache_state_)
+			 , position_(stream.position_)
+			 , size_(stream.size_)
+			 , flush_scheduler_(std::move(stream.flush_scheduler_))
 		 {
 			 stream.handle_ = INVALID_HANDLE_VALUE;
 		 }
@@ -45,6 +58,10 @@
 		 {
 			 handle_ = stream.handle_;
 			 auto_flush_ = stream.auto_flush_;
+			 cache_state_ = stream.cache_state_;
+			 position_ = stream.position_;
+			 size_ = stream.size_;
+			 flush_scheduler_ = std::move(stream.flush_scheduler_);
 			 stream.handle_ = INVALID_HANDLE_VALUE;
 			 return *this;
 		 }
@@ -54,7 +71,12 @@
 
 		 ~FileImpl()
 		 {
-			 close();
+			 try
+			 {
+				 close();
+			 }
+			 catch (...)
+			 {}
 		 }
 
          static std::unique_ptr<FileImpl> create(FILE* file)
@@ -116,13 +138,137 @@
 			 return std::make_unique<FileImpl>(handle);
 		 }
 
+		 static std::unique_ptr<FileImpl> temporary(const char* directory)
+		 {
+			 std::wstring wdirectory;
+
+			 if (directory != nullptr)
+			 {
+				 wdirectory = babel::string_cast(directory, strlen(directory), "UTF-8");
+			 }
+			 else
+			 {
+				 wchar_t buffer[MAX_PATH + 1];
+				 auto length = ::GetTempPathW(MAX_PATH + 1, buffer);
+				 THROW_IF(length == 0, WIN32_ERROR("GetTempPath"));
+				 wdirectory.assign(buffer, length);
+			 }
+
+			 wchar_t path[MAX_PATH];
+			 THROW_IF(::GetTempFileNameW(wdirectory.c_str(), L"ios", 0, path) == 0, WIN32_ERROR("GetTempFileName"));
+
+			 auto handle = ::CreateFileW(path, FILE_GENERIC_WRITE | FILE_GENERIC_READ, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+			 THROW_IF(handle == INVALID_HANDLE_VALUE, WIN32_ERROR("CreateFile"));
+			 return std::make_unique<FileImpl>(handle);
+		 }
+
+		 HANDLE native_handle() const { return handle_; }
+
 		 bool auto_flush() const { return auto_flush_; }
 		 void set_auto_flush(bool val) { auto_flush_ = val; }
 
+		 FlushPolicy flush_policy() const
+		 {
+			 return flush_scheduler_ ? flush_scheduler_->policy() : FlushPolicy();
+		 }
+
+		 void set_flush_policy(const FlushPolicy& policy)
+		 {
+			 if (!flush_scheduler_)
+			 {
+				 auto handle = handle_;
+				 flush_scheduler_ = std::make_unique<FlushScheduler>([handle]()
+				 {
+					 THROW_IF(!::FlushFileBuffers(handle), WIN32_ERROR("FlushFileBuffers"));
+				 });
+			 }
+
+			 flush_scheduler_->set_policy(policy);
+		 }
+
+		 // FlushFileBuffers always persists the metadata as well
+		 void flush()
+		 {
+			 if (flush_scheduler_)
+			 {
+				 flush_scheduler_->flush();
+			 }
+			 else
+			 {
+				 THROW_IF(!::FlushFileBuffers(handle_), WIN32_ERROR("FlushFileBuffers"));
+			 }
+		 }
+
+		 void sync()
+		 {
+			 flush();
+		 }
+
+		 bool cache_state() const { return cache_state_; }
+
+		 void set_cache_state(bool val)
+		 {
+			 if (val && !cache_state_)
+			 {
+				 size_ = file_size();
+			 }
+
+			 cache_state_ = val;
+		 }
+
+		 // FILE_FLAG_NO_BUFFERING can only be requested when the file is opened
+		 bool direct_io() const { return false; }
+
+		 void set_direct_io(bool val)
+		 {
+			 THROW_IF(val, IOStreamsException(errors::NOT_SUPPORTED));
+		 }
+
+		 // access hints are only honoured through the CreateFile flags on Windows
+		 void advise(FileAccessPattern, size_type, size_type)
+		 {}
+
+		 void reserve(size_type new_size)
+		 {
+			 if (new_size > size())
+			 {
+				 FILE_ALLOCATION_INFO info;
+				 info.AllocationSize.QuadPart = static_cast<LONGLONG>(new_size);
+				 THROW_IF(!::SetFileInformationByHandle(handle_, FileAllocationInfo, &info, sizeof(info)), WIN32_ERROR("SetFileInformationByHandle"));
+			 }
+		 }
+
+		 void refresh()
+		 {
+			 if (cache_state_)
+			 {
+				 size_ = file_size();
+
+				 // the file may have been truncated through another handle
+				 if (position_ > size_)
+				 {
+					 position_ = size_;
+				 }
+			 }
+		 }
+
 		 void close()
 		 {
 			 if (handle_ != INVALID_HANDLE_VALUE)
 			 {
+				 if (flush_scheduler_)
+				 {
+					 auto pending_bytes = flush_scheduler_->shutdown();
+					 flush_scheduler_.reset();
+
+					 if (pending_bytes != 0 && !::FlushFileBuffers(handle_))
+					 {
+						 ::CloseHandle(handle_);
+						 handle_ = INVALID_HANDLE_VALUE;
+						 throw WIN32_ERROR("FlushFileBuffers");
+					 }
+				 }
+
 				 ::CloseHandle(handle_);
 				 handle_ = INVALID_HANDLE_VALUE;
 			 }
@@ -130,75 +276,138 @@
 
 		 size_type size() const
 		 {
-			 LARGE_INTEGER size = { 0 };
-			 THROW_IF(!::GetFileSizeEx(handle_, &size), WIN32_ERROR("GetFileSizeEx"));
-			 return static_cast<size_type>(size.QuadPart);
+			 return cache_state_ ? size_ : file_size();
 		 }
 
 		 size_type tell() const
 		 {
-			 LARGE_INTEGER pos = { 0 };
-			 THROW_IF(!::SetFilePointerEx(handle_, pos, &pos, static_cast<DWORD>(std::ios_base::cur)), WIN32_ERROR("SetFilePointerEx"));
-			 return static_cast<size_type>(pos.QuadPart);
+			 return position_;
 		 }
 
 		 void seek(off_type off, std::ios_base::seekdir way = std::ios_base::beg)
 		 {
-			 FileStream<byte_type>::check_seek_range(off, way, tell(), size());
-
-			 LARGE_INTEGER pos;
-			 pos.QuadPart = off;
-			 THROW_IF(!::SetFilePointerEx(handle_, pos, &pos, static_cast<DWORD>(way)), WIN32_ERROR("SetFilePointerEx"));
+			 position_ = FileStream<byte_type>::check_seek_range(off, way, tell(), size());
 		 }
 
 		 void resize(size_type new_size)
 		 {
-			 auto current_position = tell();
+			 FILE_END_OF_FILE_INFO info;
+			 info.EndOfFile.QuadPart = static_cast<LONGLONG>(new_size);
+			 THROW_IF(!::SetFileInformationByHandle(handle_, FileEndOfFileInfo, &info, sizeof(info)), WIN32_ERROR("SetFileInformationByHandle"));
 
-			 if (current_position != new_size)
+			 if (position_ > new_size)
 			 {
-				 LARGE_INTEGER pos;
-				 pos.QuadPart = new_size;
-				 THROW_IF(!::SetFilePointerEx(handle_, pos, &pos, FILE_BEGIN), WIN32_ERROR("SetFilePointerEx"));
+				 position_ = new_size;
 			 }
 
-			 THROW_IF(!::SetEndOfFile(handle_), WIN32_ERROR("SetEndOfFile"));
+			 size_ = new_size;
+		 }
 
-			 if (current_position != new_size)
-			 {
-				 DWORD way{ FILE_BEGIN };
+		 count_type read(byte_type* buffer, count_type count)
+		 {
+			 auto read_bytes = pread(position_, buffer, count);
+			 position_ += read_bytes;
+			 return read_bytes;
+		 }
+
+		 count_type write(const byte_type* data, count_type size)
+		 {
+			 auto written_bytes = pwrite(position_, data, size);
+			 position_ += written_bytes;
+			 return written_bytes;
+		 }
+
+		 count_type readv(const Buffer* buffers, count_type count)
+		 {
+			 count_type read_bytes{ 0 };
 
-				 LARGE_INTEGER pos;
-				 pos.QuadPart = current_position;
+			 for (count_type i = 0; i < count; ++i)
+			 {
+				 auto bytes = read(buffers[i].data, buffers[i].size);
+				 read_bytes += bytes;
 
-				 if (current_position > new_size)
+				 if (bytes < buffers[i].size)
 				 {
-					 way = FILE_END;
-					 pos.QuadPart = 0;
+					 break;
 				 }
+			 }
+
+			 return read_bytes;
+		 }
 
-				 THROW_IF(!::SetFilePointerEx(handle_, pos, &pos, way), WIN32_ERROR("SetFilePointerEx"));
+		 count_type writev(const ConstBuffer* buffers, count_type count)
+		 {
+			 count_type written_bytes{ 0 };
+
+			 for (count_type i = 0; i < count; ++i)
+			 {
+				 written_bytes += write(buffers[i].data, buffers[i].size);
 			 }
+
+			 return written_bytes;
 		 }
 
-		 count_type read(byte_type* buffer, count_type count)
+		 // the offset in the OVERLAPPED moves the file pointer of a synchronous handle, which nothing here reads
+		 count_type pread(size_type offset, byte_type* buffer, count_type count) const
 		 {
+			 OVERLAPPED overlapped = { 0 };
+			 overlapped.Offset = static_cast<DWORD>(offset);
+			 overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
 			 DWORD read_bytes{ 0 };
-			 THROW_IF(!::ReadFile(handle_, buffer, count, &read_bytes, nullptr), WIN32_ERROR("ReadFile"));
+
+			 if (!::ReadFile(handle_, buffer, count, &read_bytes, &overlapped))
+			 {
+				 THROW_IF(::GetLastError() != ERROR_HANDLE_EOF, WIN32_ERROR("ReadFile"));
+			 }
+
 			 return static_cast<count_type>(read_bytes);
 		 }
 
-		 count_type write(const byte_type* data, count_type size)
+		 count_type pwrite(size_type offset, const byte_type* data, count_type count)
 		 {
+			 OVERLAPPED overlapped = { 0 };
+			 overlapped.Offset = static_cast<DWORD>(offset);
+			 overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
 			 DWORD written_bytes{ 0 };
-			 THROW_IF(!::WriteFile(handle_, data, size, &written_bytes, nullptr), WIN32_ERROR("WriteFile"));
+			 THROW_IF(!::WriteFile(handle_, data, count, &written_bytes, &overlapped), WIN32_ERROR("WriteFile"));
 
+			 if (offset + written_bytes > size_)
+			 {
+				 size_ = offset + written_bytes;
+			 }
+
+			 commit(written_bytes);
+
+			 return static_cast<count_type>(written_bytes);
+		 }
+
+	 private:
+		 void commit(DWORD written_bytes)
+		 {
 			 if (auto_flush_)
 			 {
 				 THROW_IF(!::FlushFileBuffers(handle_), WIN32_ERROR("FlushFileBuffers"));
 			 }
+			 else if (flush_scheduler_)
+			 {
+				 flush_scheduler_->on_write(written_bytes);
+			 }
+		 }
 
-			 return static_cast<count_type>(written_bytes);
+		 size_type file_size() const
+		 {
+			 LARGE_INTEGER size = { 0 };
+			 THROW_IF(!::GetFileSizeEx(handle_, &size), WIN32_ERROR("GetFileSizeEx"));
+			 return static_cast<size_type>(size.QuadPart);
+		 }
+
+		 size_type file_position() const
+		 {
+			 LARGE_INTEGER pos = { 0 };
+			 THROW_IF(!::SetFilePointerEx(handle_, pos, &pos, static_cast<DWORD>(std::ios_base::cur)), WIN32_ERROR("SetFilePointerEx"));
+			 return static_cast<size_type>(pos.QuadPart);
 		 }
 	 };
  }
@@ -16,6 +16,49 @@
 
 using namespace iostreams;
 
+TEST(const_array_stream_case, read_test)
+{
+	ConstArrayStream<uint8_t> stream(TEST_DATA.data(), TEST_DATA.size());
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+	EXPECT_EQ(TEST_DATA.data(), stream.data());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+
+	uint8_t buffer[4];
+	EXPECT_EQ(4u, stream.pread(9, buffer, 10));
+	EXPECT_EQ(std::vector<uint8_t>({ 10, 11, 12, 13 }), std::vector<uint8_t>(buffer, buffer + 4));
+
+	stream.seek(-3, std::ios_base::end);
+	EXPECT_EQ(3u, stream.read(buffer, 4));
+	EXPECT_EQ(11, buffer[0]);
+	EXPECT_THROW(stream.seek(14), IOStreamsException);
+}
+
+TEST(const_array_stream_case, read_only_test)
+{
+	ConstArrayStream<uint8_t> stream{ std::vector<uint8_t>(TEST_DATA) };
+	EXPECT_THROW(stream.write(TEST_DATA.data(), 1), IOStreamsException);
+	EXPECT_THROW(stream.pwrite(0, TEST_DATA.data(), 1), IOStreamsException);
+	EXPECT_THROW(stream.resize(1), IOStreamsException);
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+}
+
+TEST(const_array_stream_case, deleter_test)
+{
+	auto data = new uint8_t[TEST_DATA.size()];
+	std::memcpy(data, TEST_DATA.data(), TEST_DATA.size());
+	bool deleted{ false };
+
+	{
+		ConstArrayStream<uint8_t> stream(data, TEST_DATA.size(), [&deleted](const uint8_t* ptr) { deleted = true; delete[] ptr; });
+		auto copy = stream;
+		stream = ConstArrayStream<uint8_t>();
+		EXPECT_FALSE(deleted);
+		EXPECT_EQ(TEST_DATA, copy.read_all<std::vector<uint8_t>>());
+	}
+
+	EXPECT_TRUE(deleted);
+}
+
 TEST(array_stream_case, base64_create_test)
 {
 	FromBase64Transform<uint8_t> transformer;
@@ -61,6 +104,18 @@ TEST(array_stream_case, resize_test)
 	tests::ResizeTest(stream);
 }
 
+TEST(array_stream_case, positional_read_write_test)
+{
+	ArrayStream<uint8_t> stream;
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(array_stream_case, vectored_read_write_test)
+{
+	ArrayStream<uint8_t> stream;
+	tests::VectoredReadWriteTest(stream);
+}
+
 TEST(array_stream_case, read_all_to_string_test)
 {
 	ArrayStream<uint8_t> stream;
@@ -0,0 +1,218 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifdef __linux__
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/async_file.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <unistd.h>
+
+using namespace iostreams;
+
+namespace
+{
+	AsyncFileStream<uint8_t> CreateTempAsyncFile(AsyncEngine engine)
+	{
+		auto path = tests::CreateTempPath();
+		auto service = std::make_shared<AsyncIOService>(engine, 8, 2);
+		auto stream = AsyncFileStream<uint8_t>::open(service, path.c_str(), FileAccess::READ_WRITE, FileMode::F_OPEN_EXISTING, FileShare::NONE);
+		::unlink(path.c_str());
+		return stream;
+	}
+
+	void AsyncReadWriteTest(AsyncFileStream<uint8_t>& stream)
+	{
+		auto head = stream.async_write(0, TEST_DATA.data(), 6);
+		auto tail = stream.async_write(6, TEST_DATA.data() + 6, TEST_DATA.size() - 6);
+		stream.submit();
+		EXPECT_EQ(6u, head.get());
+		EXPECT_EQ(TEST_DATA.size() - 6, tail.get());
+		EXPECT_EQ(TEST_DATA.size(), stream.size());
+
+		std::vector<uint8_t> buffer(20);
+		auto read_bytes = stream.async_read(2, buffer.data(), buffer.size());
+		auto eof_bytes = stream.async_read(100, buffer.data(), buffer.size());
+		stream.submit();
+		EXPECT_EQ(TEST_DATA.size() - 2, read_bytes.get());
+		EXPECT_EQ(0u, eof_bytes.get());
+		EXPECT_EQ(std::vector<uint8_t>(TEST_DATA.begin() + 2, TEST_DATA.end()), std::vector<uint8_t>(buffer.begin(), buffer.begin() + TEST_DATA.size() - 2));
+	}
+
+	void AsyncBatchTest(AsyncFileStream<uint8_t>& stream)
+	{
+		static constexpr size_t COUNT{ 100 };
+		std::atomic<size_t> completed{ 0 };
+		std::atomic<size_t> written_bytes{ 0 };
+
+		for (size_t i = 0; i < COUNT; ++i)
+		{
+			stream.async_write(i * TEST_DATA.size(), TEST_DATA.data(), TEST_DATA.size(), [&](size_t count, std::exception_ptr error)
+			{
+				EXPECT_FALSE(error);
+				written_bytes += count;
+				++completed;
+			});
+		}
+
+		stream.close();
+		EXPECT_EQ(COUNT, completed.load());
+		EXPECT_EQ(COUNT * TEST_DATA.size(), written_bytes.load());
+	}
+
+	// every completion queues the next write while more operations are in flight than the queue holds
+	void AsyncChainedWriteTest(AsyncFileStream<uint8_t>& stream)
+	{
+		static constexpr size_t COUNT{ 200 };
+		static constexpr size_t IN_FLIGHT{ 32 };
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> completed{ 0 };
+		std::promise<void> done;
+		std::function<void(size_t, std::exception_ptr)> callback;
+
+		auto write_next = [&]()
+		{
+			auto i = next++;
+
+			if (i < COUNT)
+			{
+				stream.async_write(i * TEST_DATA.size(), TEST_DATA.data(), TEST_DATA.size(), callback);
+				stream.submit();
+			}
+		};
+
+		callback = [&](size_t count, std::exception_ptr error)
+		{
+			EXPECT_FALSE(error);
+			EXPECT_EQ(TEST_DATA.size(), count);
+			write_next();
+
+			if (++completed == COUNT)
+			{
+				done.set_value();
+			}
+		};
+
+		for (size_t i = 0; i < IN_FLIGHT; ++i)
+		{
+			write_next();
+		}
+
+		ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(10)));
+		EXPECT_EQ(COUNT * TEST_DATA.size(), stream.size());
+		stream.close();
+	}
+
+	// a single callback queues more writes than the completion queue of a depth 8 ring holds
+	void AsyncFanOutWriteTest(AsyncFileStream<uint8_t>& stream)
+	{
+		static constexpr size_t COUNT{ 100 };
+		std::atomic<size_t> completed{ 0 };
+		std::promise<void> done;
+
+		auto callback = [&](size_t count, std::exception_ptr error)
+		{
+			EXPECT_FALSE(error);
+			EXPECT_EQ(TEST_DATA.size(), count);
+
+			if (++completed == COUNT + 1)
+			{
+				done.set_value();
+			}
+		};
+
+		stream.async_write(0, TEST_DATA.data(), TEST_DATA.size(), [&](size_t count, std::exception_ptr error)
+		{
+			for (size_t i = 1; i <= COUNT; ++i)
+			{
+				stream.async_write(i * TEST_DATA.size(), TEST_DATA.data(), TEST_DATA.size(), callback);
+			}
+
+			stream.submit();
+			callback(count, error);
+		});
+		stream.submit();
+
+		ASSERT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(10)));
+		EXPECT_EQ((COUNT + 1) * TEST_DATA.size(), stream.size());
+		stream.close();
+	}
+}
+
+TEST(async_file_stream_case, io_uring_read_write_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::AUTO);
+	AsyncReadWriteTest(stream);
+}
+
+TEST(async_file_stream_case, thread_pool_read_write_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::THREAD_POOL);
+	EXPECT_EQ(AsyncEngine::THREAD_POOL, stream.service()->engine());
+	AsyncReadWriteTest(stream);
+}
+
+TEST(async_file_stream_case, io_uring_batch_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::AUTO);
+	AsyncBatchTest(stream);
+}
+
+TEST(async_file_stream_case, thread_pool_batch_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::THREAD_POOL);
+	AsyncBatchTest(stream);
+}
+
+TEST(async_file_stream_case, io_uring_chained_write_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::AUTO);
+	AsyncChainedWriteTest(stream);
+}
+
+TEST(async_file_stream_case, thread_pool_chained_write_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::THREAD_POOL);
+	AsyncChainedWriteTest(stream);
+}
+
+TEST(async_file_stream_case, io_uring_fan_out_write_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::AUTO);
+	AsyncFanOutWriteTest(stream);
+}
+
+TEST(async_file_stream_case, thread_pool_fan_out_write_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::THREAD_POOL);
+	AsyncFanOutWriteTest(stream);
+}
+
+TEST(async_file_stream_case, read_write_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::AUTO);
+	tests::ReadWriteTest(stream);
+}
+
+TEST(async_file_stream_case, closed_stream_test)
+{
+	auto stream = CreateTempAsyncFile(AsyncEngine::AUTO);
+	stream.close();
+
+	uint8_t value{ 0 };
+	EXPECT_THROW(stream.async_read(0, &value, 1), IOStreamsException);
+}
+
+#endif
\ No newline at end of file
@@ -22,6 +22,111 @@ static const std::string BASE64 = "CgsMDQ4PEBESExQVFhcYGRobHB0eHyAhIiMkJSYnKCkqK
 static const std::string BASE64_WITH_LINES = "CgsMDQ4PEBESExQVFhcYGRobHB0eHyAhIiMkJSYnKCkqKywtLi8wMTIzNDU2Nzg5Ojs8PT4/QEFC\r\nQ0RFRkdISUpLTE1OT1BRUlNUVVZXWFlaW1xdXl9gYWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXp7\r\nfH1+f4CBgoOEhYaHiImKi4yNjo+QkZKTlJWWl5iZmpucnZ6foKGio6SlpqeoqaqrrK2ur7CxsrO0\r\ntba3uLm6u7y9vr/AwcLDxMXGx8jJysvMzc7P0NHS09TV1tfY2drb3N3e3+Dh4uPk5ebn6Onq6+zt\r\n7u/w8fLz9PX29/j5+vv8/f7/AAECAwQFBgcICQ==";
 
 static constexpr uint8_t REPEAT_COUNT{ 1 };
+static constexpr size_t LARGE_DATA_SIZE{ 100 * 1024 + 2 };
+
+static std::vector<uint8_t> LargeData()
+{
+	std::vector<uint8_t> data(LARGE_DATA_SIZE);
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 7 + i / 251);
+	}
+
+	return data;
+}
+
+static const char STANDARD_ALPHABET[]{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/" };
+static const char URL_SAFE_ALPHABET[]{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_" };
+
+static std::string ToBase64Reference(const std::vector<uint8_t>& data, const char* alphabet = STANDARD_ALPHABET, bool padding = true)
+{
+	std::string result;
+
+	for (size_t i = 0; i < data.size(); i += 3)
+	{
+		uint32_t group = data[i] << 16;
+		group |= i + 1 < data.size() ? data[i + 1] << 8 : 0;
+		group |= i + 2 < data.size() ? data[i + 2] : 0;
+
+		result.push_back(alphabet[(group >> 18) & 0x3F]);
+		result.push_back(alphabet[(group >> 12) & 0x3F]);
+		result.push_back(i + 1 < data.size() ? alphabet[(group >> 6) & 0x3F] : '=');
+		result.push_back(i + 2 < data.size() ? alphabet[group & 0x3F] : '=');
+	}
+
+	if (!padding)
+	{
+		result.erase(result.find_last_not_of('=') + 1);
+	}
+
+	return result;
+}
+
+static std::string WrapLines(const std::string& data, size_t line_length, const std::string& line_break)
+{
+	std::string result;
+
+	for (size_t i = 0; i < data.size(); i += line_length)
+	{
+		if (i != 0)
+		{
+			result += line_break;
+		}
+
+		result += data.substr(i, line_length);
+	}
+
+	return result;
+}
+
+template<typename transform_type, typename source_type, typename destination_type, typename... Args>
+static std::vector<destination_type> TransformInChunks(const std::vector<source_type>& data, size_t chunk_size, Args&&... args)
+{
+	transform_type transformer(std::forward<Args>(args)...);
+	std::vector<destination_type> result;
+
+	auto handler = [&result](const destination_type* data, size_t size)
+	{
+		result.insert(result.end(), data, data + size);
+	};
+
+	for (size_t i = 0; i < data.size(); i += chunk_size)
+	{
+		transformer.update(data.data() + i, std::min(chunk_size, data.size() - i), handler);
+	}
+
+	transformer.update_final(handler);
+	return result;
+}
+
+// feeds the data in chunks to transform_into with an output window of the given capacity
+template<typename transform_type, typename source_type, typename destination_type, typename... Args>
+static std::vector<destination_type> TransformInto(const std::vector<source_type>& data, size_t chunk_size, size_t capacity, Args&&... args)
+{
+	transform_type transformer(std::forward<Args>(args)...);
+	std::vector<destination_type> result;
+	std::vector<destination_type> output(std::max(capacity, transformer.final_size()));
+
+	for (size_t i = 0; i < data.size(); i += chunk_size)
+	{
+		auto input = data.data() + i;
+		auto size = std::min(chunk_size, data.size() - i);
+
+		while (size > 0)
+		{
+			auto transformed = transformer.transform_into(input, size, output.data(), capacity);
+			EXPECT_TRUE(transformed.consumed > 0 || transformed.produced > 0);
+			input += transformed.consumed;
+			size -= transformed.consumed;
+			result.insert(result.end(), output.data(), output.data() + transformed.produced);
+		}
+	}
+
+	auto produced = transformer.finish_into(output.data(), output.size());
+	result.insert(result.end(), output.data(), output.data() + produced);
+	return result;
+}
 
 template<typename byte_type>
 void FromBase64Test(const std::string& data)
@@ -129,4 +234,194 @@ TEST(base64_case, bug_length_test)
 		auto actual_text = text_stream.read_all<std::string>();
 		EXPECT_EQ(expected_text, actual_text);
 	}
+}
+
+static void LargeDataTest()
+{
+	auto data = LargeData();
+	auto expected = ToBase64Reference(data);
+	std::vector<char> base64(expected.begin(), expected.end());
+
+	for (auto chunk_size : { 1001u, 4096u, 65536u })
+	{
+		auto actual = TransformInChunks<ToBase64Transform<uint8_t>, uint8_t, char>(data, chunk_size);
+		EXPECT_EQ(expected, std::string(actual.begin(), actual.end()));
+
+		EXPECT_EQ(data, (TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(base64, chunk_size)));
+	}
+}
+
+TEST(base64_case, large_data_test)
+{
+	tests::ForEachSimdLevel(LargeDataTest);
+}
+
+static void LargeDataWithLineBreaksTest()
+{
+	auto data = LargeData();
+	auto base64 = ToBase64Reference(data);
+	std::vector<char> lines;
+
+	for (size_t i = 0; i < base64.size(); i += 76)
+	{
+		auto end = base64.begin() + std::min(i + 76, base64.size());
+		lines.insert(lines.end(), base64.begin() + i, end);
+		lines.push_back('\r');
+		lines.push_back('\n');
+	}
+
+	lines.resize(lines.size() - 2);
+	EXPECT_EQ(data, (TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(lines, 4096)));
+}
+
+TEST(base64_case, large_data_with_line_breaks_test)
+{
+	tests::ForEachSimdLevel(LargeDataWithLineBreaksTest);
+}
+
+static void BadCharacterInLargeDataTest()
+{
+	auto base64 = ToBase64Reference(LargeData());
+	std::vector<char> data(base64.begin(), base64.end());
+	data[5000] = '*';
+
+	EXPECT_THROW((TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(data, 4096)), IOStreamsException);
+
+	data[5000] = static_cast<char>(0xC1);
+	EXPECT_THROW((TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(data, 4096)), IOStreamsException);
+}
+
+TEST(base64_case, bad_character_in_large_data_test)
+{
+	tests::ForEachSimdLevel(BadCharacterInLargeDataTest);
+}
+
+static void UrlSafeAlphabetTest()
+{
+	auto data = LargeData();
+	auto expected = ToBase64Reference(data, URL_SAFE_ALPHABET);
+	std::vector<char> base64(expected.begin(), expected.end());
+
+	Base64Options options;
+	options.alphabet = Base64Alphabet::URL_SAFE;
+
+	for (auto chunk_size : { 1001u, 65536u })
+	{
+		auto actual = TransformInChunks<ToBase64Transform<uint8_t>, uint8_t, char>(data, chunk_size, options);
+		EXPECT_EQ(expected, std::string(actual.begin(), actual.end()));
+
+		EXPECT_EQ(data, (TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(base64, chunk_size, Base64Alphabet::URL_SAFE)));
+	}
+
+	auto standard = ToBase64Reference(data);
+	std::vector<char> standard_base64(standard.begin(), standard.end());
+	EXPECT_THROW((TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(standard_base64, 4096, Base64Alphabet::URL_SAFE)), IOStreamsException);
+	EXPECT_THROW((TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(base64, 4096)), IOStreamsException);
+}
+
+TEST(base64_case, url_safe_alphabet_test)
+{
+	tests::ForEachSimdLevel(UrlSafeAlphabetTest);
+}
+
+TEST(base64_case, no_padding_test)
+{
+	Base64Options options;
+	options.padding = false;
+
+	std::vector<std::pair<std::string, std::string>> expected = { { "a", "YQ" }, { "ab", "YWI" }, { "abc", "YWJj" }, { "abcd", "YWJjZA" } };
+
+	for (const auto& pair : expected)
+	{
+		std::vector<uint8_t> text(pair.first.begin(), pair.first.end());
+		auto base64 = TransformInChunks<ToBase64Transform<uint8_t>, uint8_t, char>(text, 1, options);
+		EXPECT_EQ(pair.second, std::string(base64.begin(), base64.end()));
+
+		ToBase64Transform<uint8_t> transform(options);
+		EXPECT_EQ(pair.second.size(), transform.required_size(text.size()));
+
+		EXPECT_EQ(text, (TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(base64, 3)));
+	}
+
+	auto data = LargeData();
+	auto actual = TransformInChunks<ToBase64Transform<uint8_t>, uint8_t, char>(data, 4096, options);
+	EXPECT_EQ(ToBase64Reference(data, STANDARD_ALPHABET, false), std::string(actual.begin(), actual.end()));
+}
+
+TEST(base64_case, line_wrapping_test)
+{
+	auto data = LargeData();
+	auto base64 = ToBase64Reference(data);
+
+	std::vector<std::pair<uint32_t, LineBreak>> formats = { { 76, LineBreak::CRLF }, { 64, LineBreak::LF }, { 4, LineBreak::CRLF } };
+
+	for (const auto& format : formats)
+	{
+		Base64Options options;
+		options.line_length = format.first;
+		options.line_break = format.second;
+
+		auto expected = WrapLines(base64, format.first, format.second == LineBreak::CRLF ? "\r\n" : "\n");
+
+		for (auto chunk_size : { 1u, 1001u, 65536u })
+		{
+			auto actual = TransformInChunks<ToBase64Transform<uint8_t>, uint8_t, char>(data, chunk_size, 1000, options);
+			EXPECT_EQ(expected, std::string(actual.begin(), actual.end()));
+
+			EXPECT_EQ(data, (TransformInChunks<FromBase64Transform<uint8_t>, char, uint8_t>(actual, chunk_size)));
+		}
+
+		ToBase64Transform<uint8_t> transform(options);
+		EXPECT_EQ(expected.size(), transform.required_size(data.size()));
+	}
+
+	Base64Options options;
+	options.line_length = 75;
+	EXPECT_THROW(ToBase64Transform<uint8_t> transform(options), IOStreamsException);
+}
+
+TEST(base64_case, transform_into_test)
+{
+	auto data = LargeData();
+	auto base64 = ToBase64Reference(data);
+
+	Base64Options options;
+	options.line_length = 76;
+	auto wrapped = WrapLines(base64, 76, "\r\n");
+
+	for (auto capacity : { 6u, 7u, 4096u, 200000u })
+	{
+		auto actual = TransformInto<ToBase64Transform<uint8_t>, uint8_t, char>(data, 1001, capacity);
+		EXPECT_EQ(base64, std::string(actual.begin(), actual.end()));
+
+		actual = TransformInto<ToBase64Transform<uint8_t>, uint8_t, char>(data, 1001, capacity, options);
+		EXPECT_EQ(wrapped, std::string(actual.begin(), actual.end()));
+
+		EXPECT_EQ(data, (TransformInto<FromBase64Transform<uint8_t>, char, uint8_t>(actual, 999, capacity)));
+	}
+
+	// a block cut across calls, with the output full
+	ToBase64Transform<uint8_t> to_base64;
+	char output[8];
+	auto result = to_base64.transform_into(data.data(), 2, output, 0);
+	EXPECT_EQ(2u, result.consumed);
+	EXPECT_EQ(0u, result.produced);
+	result = to_base64.transform_into(data.data() + 2, 1, output, 3);
+	EXPECT_EQ(0u, result.consumed);
+	result = to_base64.transform_into(data.data() + 2, 1, output, 4);
+	EXPECT_EQ(1u, result.consumed);
+	EXPECT_EQ(base64.substr(0, 4), std::string(output, result.produced));
+
+	// to_string writes into the string directly, update_with takes any callable
+	MemoryStream<uint8_t> stream(64 * 1024);
+	stream.write(data.data(), data.size());
+	ToBase64Transform<uint8_t> stream_transform(options);
+	EXPECT_EQ(wrapped, stream.to_string(stream_transform));
+
+	std::string sink_result;
+	auto sink = [&sink_result](const char* data, size_t size) { sink_result.append(data, size); };
+	ToBase64Transform<uint8_t> sink_transform;
+	sink_transform.update_with(data.data(), data.size(), sink);
+	sink_transform.update_final_with(sink);
+	EXPECT_EQ(base64, sink_result);
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/block_allocator.h"
+#include "iostreams/memory.h"
+#include <thread>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace iostreams;
+
+TEST(block_pool_case, recycle_test)
+{
+	auto pool = BlockPool<uint8_t>::create(16, 2);
+	auto block = pool->allocate(16);
+	auto pointer = block.get();
+	EXPECT_EQ(1u, pool->used_blocks());
+	EXPECT_EQ(0u, pool->free_blocks());
+
+	block.reset();
+	EXPECT_EQ(0u, pool->used_blocks());
+	EXPECT_EQ(1u, pool->free_blocks());
+
+	block = pool->allocate(16);
+	EXPECT_EQ(pointer, block.get());
+	EXPECT_EQ(0u, pool->free_blocks());
+}
+
+TEST(block_pool_case, max_free_blocks_test)
+{
+	auto pool = BlockPool<uint8_t>::create(16, 2);
+
+	{
+		std::vector<std::shared_ptr<uint8_t>> blocks;
+
+		for (auto i = 0; i < 5; ++i)
+		{
+			blocks.push_back(pool->allocate(16));
+		}
+
+		EXPECT_EQ(5u, pool->used_blocks());
+	}
+
+	EXPECT_EQ(0u, pool->used_blocks());
+	EXPECT_EQ(2u, pool->free_blocks());
+
+	pool->trim();
+	EXPECT_EQ(0u, pool->free_blocks());
+}
+
+TEST(block_pool_case, foreign_size_test)
+{
+	auto pool = BlockPool<uint8_t>::create(16);
+	auto block = pool->allocate(32);
+	EXPECT_NE(nullptr, block.get());
+	EXPECT_EQ(0u, pool->used_blocks());
+}
+
+TEST(block_pool_case, outlive_pool_test)
+{
+	auto pool = BlockPool<uint8_t>::create(16);
+	auto block = pool->allocate(16);
+	pool.reset();
+	block.get()[15] = 1;
+	block.reset();
+}
+
+TEST(block_pool_case, concurrent_test)
+{
+	auto pool = BlockPool<uint8_t>::create(64, 8);
+	std::vector<std::thread> threads;
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		threads.emplace_back([pool]()
+		{
+			for (auto j = 0; j < 1000; ++j)
+			{
+				MemoryStream<uint8_t> stream(64, pool);
+				stream.write(TEST_DATA.data(), TEST_DATA.size());
+				stream.resize(200);
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(0u, pool->used_blocks());
+	EXPECT_LE(pool->free_blocks(), 8u);
+}
+
+TEST(block_pool_case, memory_stream_read_write_test)
+{
+	MemoryStream<uint8_t> stream(3, BlockPool<uint8_t>::create(3));
+	tests::ReadWriteTest(stream);
+}
+
+TEST(block_pool_case, memory_stream_resize_test)
+{
+	MemoryStream<uint8_t> stream(3, BlockPool<uint8_t>::create(3));
+	tests::ResizeTest(stream);
+}
+
+#ifdef __linux__
+TEST(huge_page_allocator_case, allocate_test)
+{
+	for (auto mode : { HugePageMode::TRANSPARENT, HugePageMode::EXPLICIT })
+	{
+		HugePageBlockAllocator<uint8_t> allocator(mode);
+		auto block = allocator.allocate(1024);
+		ASSERT_NE(nullptr, block.get());
+		EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block.get()) % HugePageBlockAllocator<uint8_t>::HUGE_PAGE_SIZE);
+
+		block.get()[0] = 1;
+		block.get()[HugePageBlockAllocator<uint8_t>::HUGE_PAGE_SIZE - 1] = 1;
+	}
+}
+
+TEST(huge_page_allocator_case, numa_node_test)
+{
+	// kernels without NUMA support and seccomp-filtered containers reject mbind outright
+	auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+	auto page = ::mmap(nullptr, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	ASSERT_NE(MAP_FAILED, page);
+	unsigned long node_mask = 1;
+	auto bound = ::syscall(__NR_mbind, page, page_size, MPOL_BIND, &node_mask, sizeof(node_mask) * 8, 0) == 0;
+	auto error = errno;
+	::munmap(page, page_size);
+
+	if (!bound && (error == ENOSYS || error == EPERM))
+	{
+		GTEST_SKIP() << "mbind is not available";
+	}
+
+	HugePageBlockAllocator<uint8_t> allocator(HugePageMode::TRANSPARENT, 0);
+	auto block = allocator.allocate(HugePageBlockAllocator<uint8_t>::HUGE_PAGE_SIZE);
+	block.get()[0] = 1;
+	EXPECT_EQ(0, allocator.numa_node());
+}
+
+TEST(huge_page_allocator_case, memory_stream_test)
+{
+	MemoryStream<uint8_t> stream(HugePageBlockAllocator<uint8_t>::HUGE_PAGE_SIZE, std::make_shared<HugePageBlockAllocator<uint8_t>>());
+	tests::ReadWriteTest(stream);
+	stream.resize(3 * HugePageBlockAllocator<uint8_t>::HUGE_PAGE_SIZE);
+	EXPECT_EQ(3u * HugePageBlockAllocator<uint8_t>::HUGE_PAGE_SIZE, stream.capacity());
+}
+#endif
+
+TEST(block_pool_case, memory_stream_zero_fill_test)
+{
+	auto pool = BlockPool<uint8_t>::create(4);
+
+	{
+		MemoryStream<uint8_t> stream(4, pool);
+		stream.write(TEST_DATA.data(), TEST_DATA.size());
+	}
+
+	EXPECT_EQ(4u, pool->free_blocks());
+
+	MemoryStream<uint8_t> stream(4, pool);
+	stream.write(TEST_DATA.data(), 1);
+	stream.resize(10);
+	EXPECT_EQ(std::vector<uint8_t>({ 1, 0, 0, 0, 0, 0, 0, 0, 0, 0 }), stream.read_all<std::vector<uint8_t>>());
+}
\ No newline at end of file
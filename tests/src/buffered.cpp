@@ -0,0 +1,138 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/buffered.h"
+#include "iostreams/array.h"
+
+using namespace iostreams;
+
+namespace
+{
+	BufferedStream<uint8_t> CreateBufferedStream(size_t buffer_size = 4)
+	{
+		return BufferedStream<uint8_t>(std::make_shared<ArrayStream<uint8_t>>(), buffer_size, buffer_size);
+	}
+}
+
+TEST(buffered_stream_case, to_string_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::ToStringTest(stream);
+}
+
+TEST(buffered_stream_case, seek_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::SeekTest(stream);
+}
+
+TEST(buffered_stream_case, seek_out_of_range_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::SeekOutOffRangeTest(stream);
+}
+
+TEST(buffered_stream_case, read_write_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::ReadWriteTest(stream);
+}
+
+TEST(buffered_stream_case, read_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::ReadTest(stream);
+}
+
+TEST(buffered_stream_case, resize_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::ResizeTest(stream);
+}
+
+TEST(buffered_stream_case, positional_read_write_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(buffered_stream_case, vectored_read_write_test)
+{
+	auto stream = CreateBufferedStream();
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(buffered_stream_case, unbuffered_read_write_test)
+{
+	auto stream = CreateBufferedStream(0);
+	tests::ReadWriteTest(stream);
+}
+
+TEST(buffered_stream_case, write_behind_test)
+{
+	auto stream = CreateBufferedStream(8);
+	auto& target = *stream.stream();
+
+	stream.write(TEST_DATA.data(), 3);
+	stream.write(TEST_DATA.data() + 3, 3);
+	EXPECT_EQ(0u, target.size());
+	EXPECT_EQ(6u, stream.size());
+
+	stream.seek(1);
+	stream.write(TEST_DATA.data() + 10, 2);
+	EXPECT_EQ(0u, target.size());
+
+	stream.flush();
+	EXPECT_EQ(6u, target.size());
+
+	std::vector<uint8_t> actual(6);
+	target.pread(0, actual.data(), actual.size());
+	EXPECT_EQ(std::vector<uint8_t>({ 1, 11, 12, 4, 5, 6 }), actual);
+}
+
+TEST(buffered_stream_case, read_ahead_test)
+{
+	auto target = std::make_shared<ArrayStream<uint8_t>>();
+	target->write(TEST_DATA.data(), TEST_DATA.size());
+
+	BufferedStream<uint8_t> stream(target, 8, 8);
+	stream.seek(0);
+
+	uint8_t value{ 0 };
+	EXPECT_EQ(1u, stream.read(&value, 1));
+	EXPECT_EQ(1u, value);
+
+	target->pwrite(2, TEST_DATA.data() + 12, 1);
+	stream.seek(2);
+	EXPECT_EQ(1u, stream.read(&value, 1));
+	EXPECT_EQ(3u, value);
+
+	stream.seek(8);
+	EXPECT_EQ(1u, stream.read(&value, 1));
+	EXPECT_EQ(9u, value);
+}
+
+TEST(buffered_stream_case, destructor_flush_test)
+{
+	auto target = std::make_shared<ArrayStream<uint8_t>>();
+
+	{
+		BufferedStream<uint8_t> stream(target);
+		stream.write(TEST_DATA.data(), TEST_DATA.size());
+		EXPECT_EQ(0u, target->size());
+	}
+
+	target->seek(0);
+	EXPECT_EQ(TEST_DATA, target->read_all<std::vector<uint8_t>>());
+}
\ No newline at end of file
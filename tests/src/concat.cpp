@@ -0,0 +1,101 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/concat.h"
+#include "iostreams/array.h"
+#include "iostreams/memory.h"
+
+using namespace iostreams;
+
+namespace
+{
+	ConcatStream<uint8_t> CreateConcatStream()
+	{
+		auto first = std::make_shared<ArrayStream<uint8_t>>(std::vector<uint8_t>(TEST_DATA.begin(), TEST_DATA.begin() + 3));
+		auto empty = std::make_shared<ArrayStream<uint8_t>>();
+		auto second = std::make_shared<MemoryStream<uint8_t>>(std::vector<uint8_t>(TEST_DATA.begin() + 3, TEST_DATA.begin() + 9));
+		auto third = std::make_shared<ArrayStream<uint8_t>>(std::vector<uint8_t>(TEST_DATA.begin() + 9, TEST_DATA.end()));
+		return ConcatStream<uint8_t>({ first, empty, second, third });
+	}
+}
+
+TEST(concat_stream_case, to_string_test)
+{
+	auto stream = CreateConcatStream();
+	ToHexTransform<uint8_t> transformer;
+	EXPECT_EQ("0102030405060708090a0b0c0d", stream.to_string(transformer));
+}
+
+TEST(concat_stream_case, seek_out_of_range_test)
+{
+	auto stream = CreateConcatStream();
+	tests::SeekOutOffRangeTest(stream);
+}
+
+TEST(concat_stream_case, read_test)
+{
+	auto stream = CreateConcatStream();
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+
+	std::vector<uint8_t> buffer(TEST_DATA.size());
+	stream.seek(2);
+	EXPECT_EQ(8u, stream.read(buffer.data(), 8));
+	EXPECT_EQ(std::vector<uint8_t>({ 3, 4, 5, 6, 7, 8, 9, 10 }), std::vector<uint8_t>(buffer.begin(), buffer.begin() + 8));
+	EXPECT_EQ(10u, stream.tell());
+
+	stream.seek(-1, std::ios_base::end);
+	EXPECT_EQ(1u, stream.read(buffer.data(), 10));
+	EXPECT_EQ(13, buffer[0]);
+	EXPECT_EQ(0u, stream.read(buffer.data(), 10));
+
+	EXPECT_EQ(4u, stream.pread(3, buffer.data(), 4));
+	EXPECT_EQ(std::vector<uint8_t>({ 4, 5, 6, 7 }), std::vector<uint8_t>(buffer.begin(), buffer.begin() + 4));
+	EXPECT_EQ(0u, stream.pread(13, buffer.data(), 4));
+}
+
+TEST(concat_stream_case, read_only_test)
+{
+	auto stream = CreateConcatStream();
+	EXPECT_THROW(stream.write(TEST_DATA.data(), 1), IOStreamsException);
+	EXPECT_THROW(stream.pwrite(0, TEST_DATA.data(), 1), IOStreamsException);
+	EXPECT_THROW(stream.resize(1), IOStreamsException);
+}
+
+TEST(concat_stream_case, refresh_test)
+{
+	auto first = std::make_shared<ArrayStream<uint8_t>>(std::vector<uint8_t>(TEST_DATA.begin(), TEST_DATA.begin() + 5));
+	ConcatStream<uint8_t> stream;
+	EXPECT_EQ(0u, stream.size());
+
+	stream.append(first);
+	stream.append(std::make_shared<ArrayStream<uint8_t>>(std::vector<uint8_t>(TEST_DATA.begin() + 8, TEST_DATA.end())));
+	EXPECT_EQ(10u, stream.size());
+
+	first->seek(0, std::ios_base::end);
+	first->write(TEST_DATA.data() + 5, 3);
+	stream.refresh();
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+}
+
+TEST(concat_stream_case, copy_test)
+{
+	auto stream = CreateConcatStream();
+	stream.seek(1);
+	MemoryStream<uint8_t> result(4);
+	EXPECT_EQ(11u, copy<uint8_t>(&stream, &result, 11));
+	EXPECT_EQ(12u, stream.tell());
+	EXPECT_EQ(std::vector<uint8_t>(TEST_DATA.begin() + 1, TEST_DATA.end() - 1), result.read_all<std::vector<uint8_t>>());
+}
\ No newline at end of file
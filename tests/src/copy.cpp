@@ -0,0 +1,141 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "iostreams/array.h"
+#include "iostreams/file.h"
+#include "iostreams/memory.h"
+
+using namespace iostreams;
+
+namespace
+{
+	std::vector<uint8_t> ReadAll(IStream<uint8_t>& stream)
+	{
+		std::vector<uint8_t> result(static_cast<size_t>(stream.size()));
+		stream.pread(0, result.data(), result.size());
+		return result;
+	}
+}
+
+TEST(copy_case, file_to_file_test)
+{
+	auto source = tests::CreateTempFile();
+	auto destination = tests::CreateTempFile();
+	source.write(TEST_DATA.data(), TEST_DATA.size());
+	destination.write(TEST_DATA.data(), 2);
+	source.seek(3);
+
+	EXPECT_EQ(5u, copy<uint8_t>(&source, &destination, 5));
+	EXPECT_EQ(8u, source.tell());
+	EXPECT_EQ(7u, destination.tell());
+	EXPECT_EQ(std::vector<uint8_t>({ 1, 2, 4, 5, 6, 7, 8 }), ReadAll(destination));
+}
+
+TEST(copy_case, cached_file_to_file_test)
+{
+	auto source = tests::CreateTempFile();
+	auto destination = tests::CreateTempFile();
+	destination.set_cache_state(true);
+	source.write(TEST_DATA.data(), TEST_DATA.size());
+	source.seek(0);
+
+	EXPECT_EQ(TEST_DATA.size(), copy<uint8_t>(&source, &destination, 100));
+	EXPECT_EQ(TEST_DATA.size(), destination.size());
+	EXPECT_EQ(TEST_DATA.size(), destination.tell());
+	EXPECT_EQ(TEST_DATA, ReadAll(destination));
+}
+
+#if defined (__linux__) || defined (__APPLE__)
+TEST(copy_case, direct_file_to_file_test)
+{
+	auto source = tests::CreateTempFile();
+	auto destination = tests::CreateTempFile();
+	destination.set_direct_io(true);
+	source.write(TEST_DATA.data(), TEST_DATA.size());
+	source.seek(0);
+	destination.write(TEST_DATA.data(), 3);
+
+	EXPECT_EQ(10u, copy<uint8_t>(&source, &destination, 10));
+	EXPECT_EQ(13u, destination.size());
+	EXPECT_EQ(13u, destination.tell());
+
+	std::vector<uint8_t> expected(TEST_DATA.begin(), TEST_DATA.begin() + 3);
+	expected.insert(expected.end(), TEST_DATA.begin(), TEST_DATA.begin() + 10);
+	EXPECT_EQ(expected, ReadAll(destination));
+}
+#endif
+
+TEST(copy_case, flush_policy_file_to_file_test)
+{
+	auto source = tests::CreateTempFile();
+	auto destination = tests::CreateTempFile();
+
+	FlushPolicy policy;
+	policy.bytes_threshold = 4;
+	destination.set_flush_policy(policy);
+	source.write(TEST_DATA.data(), TEST_DATA.size());
+	source.seek(0);
+
+	EXPECT_EQ(TEST_DATA.size(), copy<uint8_t>(&source, &destination, TEST_DATA.size()));
+	EXPECT_EQ(TEST_DATA.size(), destination.size());
+	EXPECT_EQ(TEST_DATA, ReadAll(destination));
+	EXPECT_NO_THROW(destination.close());
+}
+
+TEST(copy_case, memory_to_file_test)
+{
+	MemoryStream<uint8_t> source(3);
+	source.write(TEST_DATA.data(), TEST_DATA.size());
+	source.seek(2);
+
+	auto destination = tests::CreateTempFile();
+	EXPECT_EQ(10u, copy<uint8_t>(&source, &destination, 10));
+	EXPECT_EQ(12u, source.tell());
+	EXPECT_EQ(std::vector<uint8_t>(TEST_DATA.begin() + 2, TEST_DATA.begin() + 12), ReadAll(destination));
+}
+
+TEST(copy_case, file_to_memory_test)
+{
+	auto source = tests::CreateTempFile();
+	source.write(TEST_DATA.data(), TEST_DATA.size());
+	source.seek(0);
+
+	MemoryStream<uint8_t> destination(4);
+	destination.write(TEST_DATA.data(), 1);
+
+	EXPECT_EQ(TEST_DATA.size(), copy<uint8_t>(&source, &destination, TEST_DATA.size()));
+	EXPECT_EQ(TEST_DATA.size() + 1, destination.size());
+	EXPECT_EQ(TEST_DATA.size() + 1, destination.tell());
+
+	std::vector<uint8_t> expected({ 1 });
+	expected.insert(expected.end(), TEST_DATA.begin(), TEST_DATA.end());
+	EXPECT_EQ(expected, ReadAll(destination));
+}
+
+TEST(copy_case, buffered_test)
+{
+	ArrayStream<uint8_t> source;
+	source.write(TEST_DATA.data(), TEST_DATA.size());
+	source.seek(10);
+
+	ArrayStream<uint8_t> destination;
+	EXPECT_EQ(3u, copy<uint8_t>(&source, &destination, 100));
+	EXPECT_EQ(0u, copy<uint8_t>(&source, &destination, 100));
+	EXPECT_EQ(std::vector<uint8_t>({ 11, 12, 13 }), ReadAll(destination));
+}
+
+TEST(copy_case, same_stream_test)
+{
+	ArrayStream<uint8_t> stream;
+	EXPECT_THROW(copy<uint8_t>(&stream, &stream, 1), IOStreamsException);
+}
\ No newline at end of file
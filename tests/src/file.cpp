@@ -13,25 +13,17 @@
 #include "utils.h"
 #include "stream_test.h"
 #include "iostreams/file.h"
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
+#elif defined (__linux__) || defined (__APPLE__)
+#include <unistd.h>
 #endif
 
 using namespace iostreams;
 
-FileStream<uint8_t> CreateTempFile()
-{
-#ifdef _WIN32
-	char buffer[L_tmpnam_s];
-	tmpnam_s(buffer, L_tmpnam_s);
-	return FileStream<uint8_t>::open(buffer, FileAccess::READ_WRITE, FileMode::F_CREATE_NEW, FileShare::SHARE_DELETE, FILE_FLAG_DELETE_ON_CLOSE);
-#elif defined(__APPLE__) & defined(__MACH__)
-	return FileStream<uint8_t>::create(::tmpfile());
-#elif defined(__linux__)
-	return FileStream<uint8_t>::create(::tmpfile64());
-#endif
-}
+using tests::CreateTempFile;
 
 TEST(file_stream_case, to_string_test)
 {
@@ -69,6 +61,98 @@ TEST(file_stream_case, resize_test)
 	tests::ResizeTest(stream);
 }
 
+TEST(file_stream_case, positional_read_write_test)
+{
+	auto stream = CreateTempFile();
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(file_stream_case, vectored_read_write_test)
+{
+	auto stream = CreateTempFile();
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(file_stream_case, flush_policy_test)
+{
+	auto stream = CreateTempFile();
+	EXPECT_EQ(0u, stream.flush_policy().bytes_threshold);
+
+	FlushPolicy policy;
+	policy.bytes_threshold = 8;
+	policy.interval = std::chrono::milliseconds(50);
+	stream.set_flush_policy(policy);
+	EXPECT_EQ(8u, stream.flush_policy().bytes_threshold);
+	EXPECT_EQ(50, stream.flush_policy().interval.count());
+	EXPECT_FALSE(stream.flush_policy().background);
+
+	tests::ReadWriteTest(stream);
+	EXPECT_NO_THROW(stream.flush());
+	EXPECT_NO_THROW(stream.sync());
+}
+
+TEST(file_stream_case, background_flush_policy_test)
+{
+	auto stream = CreateTempFile();
+
+	FlushPolicy policy;
+	policy.interval = std::chrono::milliseconds(1);
+	policy.background = true;
+	stream.set_flush_policy(policy);
+
+	for (auto i = 0; i < 100; ++i)
+	{
+		stream.write(TEST_DATA.data(), TEST_DATA.size());
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	EXPECT_EQ(100u * TEST_DATA.size(), stream.size());
+
+	stream.set_flush_policy(FlushPolicy());
+	EXPECT_FALSE(stream.flush_policy().background);
+	EXPECT_NO_THROW(stream.close());
+}
+
+TEST(file_stream_case, concurrent_pread_test)
+{
+	static constexpr size_t THREADS_COUNT{ 4 };
+	static constexpr size_t CHUNK_SIZE{ 64 * 1024 };
+
+	auto stream = CreateTempFile();
+	std::vector<uint8_t> data(THREADS_COUNT * CHUNK_SIZE);
+
+	for (auto i = 0u; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 7);
+	}
+
+	stream.write(data.data(), data.size());
+	stream.seek(0);
+
+	std::vector<std::vector<uint8_t>> chunks(THREADS_COUNT, std::vector<uint8_t>(CHUNK_SIZE));
+	std::vector<std::thread> threads;
+
+	for (auto i = 0u; i < THREADS_COUNT; ++i)
+	{
+		threads.emplace_back([&stream, &chunks, i]()
+		{
+			stream.pread(i * CHUNK_SIZE, chunks[i].data(), CHUNK_SIZE);
+		});
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(0u, stream.tell());
+
+	for (auto i = 0u; i < THREADS_COUNT; ++i)
+	{
+		EXPECT_EQ(std::vector<uint8_t>(data.begin() + i * CHUNK_SIZE, data.begin() + (i + 1) * CHUNK_SIZE), chunks[i]);
+	}
+}
+
 TEST(file_stream_case, read_all_to_string_test)
 {
 	auto stream = CreateTempFile();
@@ -79,4 +163,238 @@ TEST(file_stream_case, read_all_to_vector_test)
 {
 	auto stream = CreateTempFile();
 	tests::ReadAllToVectorTest(stream);
-}
\ No newline at end of file
+}
+
+FileStream<uint8_t> CreateCachedTempFile()
+{
+	auto stream = CreateTempFile();
+	stream.set_cache_state(true);
+	return stream;
+}
+
+TEST(file_stream_case, cached_seek_test)
+{
+	auto stream = CreateCachedTempFile();
+	tests::SeekTest(stream);
+}
+
+TEST(file_stream_case, cached_seek_out_of_range_test)
+{
+	auto stream = CreateCachedTempFile();
+	tests::SeekOutOffRangeTest(stream);
+}
+
+TEST(file_stream_case, cached_read_write_test)
+{
+	auto stream = CreateCachedTempFile();
+	tests::ReadWriteTest(stream);
+}
+
+TEST(file_stream_case, cached_positional_read_write_test)
+{
+	auto stream = CreateCachedTempFile();
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(file_stream_case, cached_vectored_read_write_test)
+{
+	auto stream = CreateCachedTempFile();
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(file_stream_case, cached_resize_test)
+{
+	auto stream = CreateCachedTempFile();
+	tests::ResizeTest(stream);
+}
+
+TEST(file_stream_case, cached_state_test)
+{
+	auto stream = CreateTempFile();
+	stream.write(TEST_DATA.data(), 5);
+	stream.seek(2);
+
+	stream.set_cache_state(true);
+	EXPECT_EQ(2u, stream.tell());
+	EXPECT_EQ(5u, stream.size());
+
+	stream.write(TEST_DATA.data() + 2, TEST_DATA.size() - 2);
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+
+	stream.set_cache_state(false);
+	EXPECT_EQ(TEST_DATA.size(), stream.tell());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+}
+
+#if defined (__linux__) || defined (__APPLE__)
+TEST(file_stream_case, cached_refresh_test)
+{
+	auto stream = CreateCachedTempFile();
+	stream.write(TEST_DATA.data(), 5);
+
+	EXPECT_EQ(static_cast<ssize_t>(TEST_DATA.size() - 5), ::pwrite(stream.native_handle(), TEST_DATA.data() + 5, TEST_DATA.size() - 5, 5));
+	EXPECT_EQ(5u, stream.size());
+
+	stream.refresh();
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+	EXPECT_EQ(5u, stream.tell());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+
+	stream.seek(0, std::ios_base::end);
+	EXPECT_EQ(0, ::ftruncate(stream.native_handle(), 3));
+	stream.refresh();
+	EXPECT_EQ(3u, stream.size());
+	EXPECT_EQ(3u, stream.tell());
+}
+
+TEST(file_stream_case, advise_test)
+{
+	auto stream = CreateTempFile();
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+
+	for (auto pattern : { FileAccessPattern::SEQUENTIAL, FileAccessPattern::RANDOM, FileAccessPattern::WILL_NEED, FileAccessPattern::DONT_NEED, FileAccessPattern::NORMAL })
+	{
+		EXPECT_NO_THROW(stream.advise(pattern));
+		EXPECT_NO_THROW(stream.advise(pattern, 2, 5));
+	}
+
+	stream.seek(0);
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+}
+
+TEST(file_stream_case, reserve_test)
+{
+	auto stream = CreateTempFile();
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+	stream.reserve(1024 * 1024);
+
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+	EXPECT_EQ(TEST_DATA.size(), stream.tell());
+
+	stream.resize(64 * 1024);
+	EXPECT_EQ(64u * 1024, stream.size());
+	EXPECT_EQ(TEST_DATA.size(), stream.tell());
+}
+
+TEST(file_stream_case, temporary_test)
+{
+	auto stream = FileStream<uint8_t>::temporary();
+	EXPECT_TRUE(stream.path().empty());
+	EXPECT_EQ(0u, stream.size());
+
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+	stream.seek(0);
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+
+	auto other = FileStream<uint8_t>::temporary(".");
+	EXPECT_EQ(0u, other.size());
+}
+
+FileStream<uint8_t> CreateDirectTempFile()
+{
+	auto stream = CreateTempFile();
+	stream.set_direct_io(true);
+	return stream;
+}
+
+TEST(file_stream_case, direct_to_string_test)
+{
+	auto stream = CreateDirectTempFile();
+	tests::ToStringTest(stream);
+}
+
+TEST(file_stream_case, direct_seek_test)
+{
+	auto stream = CreateDirectTempFile();
+	tests::SeekTest(stream);
+}
+
+TEST(file_stream_case, direct_read_write_test)
+{
+	auto stream = CreateDirectTempFile();
+	tests::ReadWriteTest(stream);
+}
+
+TEST(file_stream_case, direct_resize_test)
+{
+	auto stream = CreateDirectTempFile();
+	tests::ResizeTest(stream);
+}
+
+TEST(file_stream_case, direct_positional_read_write_test)
+{
+	auto stream = CreateDirectTempFile();
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(file_stream_case, direct_vectored_read_write_test)
+{
+	auto stream = CreateDirectTempFile();
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(file_stream_case, direct_unaligned_test)
+{
+	auto stream = CreateDirectTempFile();
+	EXPECT_TRUE(stream.direct_io());
+	EXPECT_TRUE(stream.cache_state());
+
+	std::vector<uint8_t> expected(3 * 4096 + 777);
+
+	for (size_t i = 0; i < expected.size(); ++i)
+	{
+		expected[i] = static_cast<uint8_t>(i * 7);
+	}
+
+	size_t offset{ 0 };
+
+	for (auto chunk : { 3, 4093, 5000, 1, 10000 })
+	{
+		auto size = std::min<size_t>(chunk, expected.size() - offset);
+		EXPECT_EQ(size, stream.write(expected.data() + offset, size));
+		offset += size;
+	}
+
+	EXPECT_EQ(expected.size(), stream.size());
+	EXPECT_EQ(2u, stream.pwrite(4095, TEST_DATA.data(), 2));
+	expected[4095] = TEST_DATA[0];
+	expected[4096] = TEST_DATA[1];
+
+	std::vector<uint8_t> actual(expected.size());
+	EXPECT_EQ(expected.size(), stream.pread(0, actual.data(), actual.size()));
+	EXPECT_EQ(expected, actual);
+
+	EXPECT_THROW(stream.set_cache_state(false), IOStreamsException);
+	EXPECT_TRUE(stream.cache_state());
+
+	stream.set_direct_io(false);
+	EXPECT_EQ(expected.size(), static_cast<size_t>(::lseek(stream.native_handle(), 0, SEEK_END)));
+}
+
+TEST(file_stream_case, direct_refresh_test)
+{
+	auto stream = CreateDirectTempFile();
+	stream.write(TEST_DATA.data(), 10);
+
+	stream.refresh();
+	EXPECT_EQ(10u, stream.size());
+	EXPECT_EQ(10u, stream.tell());
+
+	EXPECT_EQ(0, ::ftruncate(stream.native_handle(), 3));
+	stream.refresh();
+	EXPECT_EQ(3u, stream.size());
+	EXPECT_EQ(3u, stream.tell());
+}
+
+TEST(file_stream_case, direct_close_error_test)
+{
+	auto stream = CreateDirectTempFile();
+	stream.write(TEST_DATA.data(), 10);
+
+	// the padding can no longer be truncated
+	EXPECT_EQ(0, ::close(stream.native_handle()));
+	EXPECT_THROW(stream.close(), liberror::PosixException);
+	EXPECT_THROW(stream.size(), IOStreamsException);
+	EXPECT_NO_THROW(stream.close());
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,165 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "tests.h"
+#include "flush_scheduler.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace iostreams;
+
+namespace
+{
+	// polls instead of sleeping a fixed time, a loaded machine may delay the background flusher
+	template<typename predicate_type>
+	bool WaitFor(predicate_type predicate)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+		while (!predicate())
+		{
+			if (std::chrono::steady_clock::now() > deadline)
+			{
+				return false;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		return true;
+	}
+}
+
+TEST(flush_scheduler_case, bytes_threshold_test)
+{
+	std::atomic<int> syncs{ 0 };
+	FlushScheduler scheduler([&syncs]() { ++syncs; });
+
+	FlushPolicy policy;
+	policy.bytes_threshold = 10;
+	scheduler.set_policy(policy);
+
+	scheduler.on_write(4);
+	scheduler.on_write(4);
+	EXPECT_EQ(0, syncs.load());
+
+	scheduler.on_write(4);
+	EXPECT_EQ(1, syncs.load());
+
+	scheduler.on_write(9);
+	EXPECT_EQ(1, syncs.load());
+
+	scheduler.on_write(1);
+	EXPECT_EQ(2, syncs.load());
+	EXPECT_EQ(0u, scheduler.shutdown());
+}
+
+TEST(flush_scheduler_case, interval_test)
+{
+	std::atomic<int> syncs{ 0 };
+	FlushScheduler scheduler([&syncs]() { ++syncs; });
+
+	FlushPolicy policy;
+	policy.interval = std::chrono::milliseconds(50);
+	scheduler.set_policy(policy);
+
+	scheduler.on_write(1);
+	EXPECT_EQ(0, syncs.load());
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	scheduler.on_write(1);
+	EXPECT_EQ(1, syncs.load());
+
+	scheduler.on_write(1);
+	EXPECT_EQ(1, syncs.load());
+	EXPECT_EQ(1u, scheduler.shutdown());
+}
+
+TEST(flush_scheduler_case, background_test)
+{
+	static constexpr int WRITES{ 100 };
+	std::atomic<int> syncs{ 0 };
+	FlushScheduler scheduler([&syncs]() { ++syncs; });
+
+	FlushPolicy policy;
+	policy.interval = std::chrono::milliseconds(10);
+	policy.background = true;
+	scheduler.set_policy(policy);
+
+	for (auto i = 0; i < WRITES; ++i)
+	{
+		scheduler.on_write(1);
+	}
+
+	// the writes are grouped into a few syncs on the flusher thread
+	ASSERT_TRUE(WaitFor([&syncs]() { return syncs.load() > 0; }));
+	EXPECT_LT(syncs.load(), WRITES);
+
+	// nothing pending, nothing to sync
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	auto idle_syncs = syncs.load();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_EQ(idle_syncs, syncs.load());
+	EXPECT_EQ(0u, scheduler.shutdown());
+}
+
+TEST(flush_scheduler_case, background_error_test)
+{
+	std::atomic<int> syncs{ 0 };
+	FlushScheduler scheduler([&syncs]()
+	{
+		++syncs;
+		throw std::runtime_error("sync");
+	});
+
+	FlushPolicy policy;
+	policy.interval = std::chrono::milliseconds(1);
+	policy.background = true;
+	scheduler.set_policy(policy);
+
+	scheduler.on_write(3);
+	ASSERT_TRUE(WaitFor([&syncs]() { return syncs.load() > 0; }));
+	scheduler.set_policy(FlushPolicy());
+
+	// the failed sync is reported once and its bytes stay pending
+	EXPECT_THROW(scheduler.on_write(2), std::runtime_error);
+	EXPECT_EQ(5u, scheduler.shutdown());
+}
+
+TEST(flush_scheduler_case, flush_error_test)
+{
+	auto fail = true;
+	FlushScheduler scheduler([&fail]()
+	{
+		if (fail)
+		{
+			throw std::runtime_error("sync");
+		}
+	});
+
+	FlushPolicy policy;
+	policy.bytes_threshold = 4;
+	scheduler.set_policy(policy);
+
+	EXPECT_THROW(scheduler.on_write(4), std::runtime_error);
+	EXPECT_THROW(scheduler.flush(), std::runtime_error);
+
+	fail = false;
+	scheduler.on_write(1);
+	EXPECT_EQ(0u, scheduler.shutdown());
+
+	scheduler.on_write(2);
+	EXPECT_THROW(scheduler.flush([]() { throw std::runtime_error("fsync"); }), std::runtime_error);
+	EXPECT_EQ(2u, scheduler.shutdown());
+}
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include "tests.h"
 #include "transform_test.h"
 #include "iostreams/transform/string_transform/hex.h"
+#include "iostreams/error.h"
+#include "iostreams/memory.h"
 #include <algorithm>
 
 using namespace iostreams;
@@ -20,6 +22,68 @@ static const std::vector<uint8_t> HEX_TEST_DATA{ 10, 11, 12, 13, 14, 15, 16, 17,
 static const std::string HEX{ "0a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff00010203040506070809" };
 
 static constexpr uint8_t REPEAT_COUNT{ 1 };
+static constexpr size_t LARGE_DATA_SIZE{ 100 * 1024 + 5 };
+
+static std::string ToHexReference(const std::vector<uint8_t>& data, const char* digits)
+{
+	std::string result;
+
+	for (auto byte : data)
+	{
+		result.push_back(digits[byte >> 4]);
+		result.push_back(digits[byte & 0x0F]);
+	}
+
+	return result;
+}
+
+static std::vector<uint8_t> LargeData()
+{
+	std::vector<uint8_t> data(LARGE_DATA_SIZE);
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 13 + i / 241);
+	}
+
+	return data;
+}
+
+static std::string ToHex(ToHexTransform<uint8_t>& transform, const std::vector<uint8_t>& data, size_t chunk_size)
+{
+	std::string result;
+
+	auto handler = [&result](const char* data, size_t size)
+	{
+		result.append(data, size);
+	};
+
+	for (size_t i = 0; i < data.size(); i += chunk_size)
+	{
+		transform.update(data.data() + i, std::min(chunk_size, data.size() - i), handler);
+	}
+
+	transform.update_final(handler);
+	return result;
+}
+
+static std::vector<uint8_t> FromHex(FromHexTransform<uint8_t>& transform, const std::string& data, size_t chunk_size)
+{
+	std::vector<uint8_t> result;
+
+	auto handler = [&result](const uint8_t* data, size_t size)
+	{
+		result.insert(result.end(), data, data + size);
+	};
+
+	for (size_t i = 0; i < data.size(); i += chunk_size)
+	{
+		transform.update(data.data() + i, std::min(chunk_size, data.size() - i), handler);
+	}
+
+	transform.update_final(handler);
+	return result;
+}
 
 template<typename byte_type>
 void FromHexTest(const std::string& data)
@@ -100,4 +164,142 @@ TEST(hex_case, from_split_space_hex_test)
 	buffer.push_back(HEX[i++]);
 
 	FromHexTest<char>(std::string(buffer.begin(), buffer.end()));
+}
+
+TEST(hex_case, whitespace_test)
+{
+	std::string data = " 0a\t0b\n0c\v0d\f0e\r0f ";
+	FromHexTransform<uint8_t> transform;
+	EXPECT_EQ(12u, transform.significant_size(data.data(), data.size()));
+	EXPECT_EQ(std::vector<uint8_t>({ 10, 11, 12, 13, 14, 15 }), FromHex(transform, data, 5));
+
+	// whitespace in other locales, e.g. the Latin-1 no-break space, is not skipped
+	data = "0a" + std::string(1, static_cast<char>(0xA0)) + "0b";
+	EXPECT_EQ(5u, transform.significant_size(data.data(), data.size()));
+	EXPECT_THROW(FromHex(transform, data, 5), IOStreamsException);
+	EXPECT_EQ(2u, transform.error_offset());
+}
+
+TEST(hex_case, to_uppercase_hex_test)
+{
+	std::string uppercase_hex;
+	uppercase_hex.resize(HEX.size());
+	std::transform(HEX.begin(), HEX.end(), uppercase_hex.begin(), ::toupper);
+
+	ToHexTransform<uint8_t> transform(HexFormat::UPPERCASE);
+	EXPECT_EQ(HexFormat::UPPERCASE, transform.format());
+	EXPECT_EQ(uppercase_hex, ToHex(transform, HEX_TEST_DATA, 7));
+}
+
+static void LargeDataTest()
+{
+	auto data = LargeData();
+
+	for (auto chunk_size : { 1001u, 4096u, 65536u })
+	{
+		ToHexTransform<uint8_t> to_lowercase;
+		auto lowercase_hex = ToHex(to_lowercase, data, chunk_size);
+		EXPECT_EQ(ToHexReference(data, "0123456789abcdef"), lowercase_hex);
+
+		ToHexTransform<uint8_t> to_uppercase(1000, HexFormat::UPPERCASE);
+		auto uppercase_hex = ToHex(to_uppercase, data, chunk_size);
+		EXPECT_EQ(ToHexReference(data, "0123456789ABCDEF"), uppercase_hex);
+
+		FromHexTransform<uint8_t> from_hex;
+		EXPECT_EQ(data, FromHex(from_hex, lowercase_hex, chunk_size));
+		EXPECT_EQ(data, FromHex(from_hex, uppercase_hex, chunk_size + 1));
+	}
+}
+
+TEST(hex_case, large_data_test)
+{
+	tests::ForEachSimdLevel(LargeDataTest);
+}
+
+static void TransformIntoTest()
+{
+	auto data = LargeData();
+	auto hex = ToHexReference(data, "0123456789abcdef");
+	auto spaced = hex;
+
+	for (size_t i = 10; i < spaced.size(); i += 11)
+	{
+		spaced.insert(i, 1, i % 2 == 0 ? ' ' : '\n');
+	}
+
+	for (auto capacity : { 1u, 3u, 4096u, 300000u })
+	{
+		ToHexTransform<uint8_t> to_hex;
+		std::string actual;
+		std::vector<char> output(capacity);
+
+		for (size_t i = 0; i < data.size();)
+		{
+			auto result = to_hex.transform_into(data.data() + i, data.size() - i, output.data(), capacity);
+			i += result.consumed;
+			actual.append(output.data(), result.produced);
+
+			if (capacity < 2)
+			{
+				EXPECT_EQ(0u, result.consumed);
+				break;
+			}
+		}
+
+		EXPECT_EQ(capacity < 2 ? "" : hex, actual);
+
+		FromHexTransform<uint8_t> from_hex;
+		std::vector<uint8_t> decoded;
+		std::vector<uint8_t> decoded_output(capacity);
+
+		for (size_t i = 0; i < spaced.size();)
+		{
+			auto size = std::min<size_t>(777, spaced.size() - i);
+			auto result = from_hex.transform_into(spaced.data() + i, size, decoded_output.data(), capacity);
+			i += result.consumed;
+			decoded.insert(decoded.end(), decoded_output.data(), decoded_output.data() + result.produced);
+		}
+
+		EXPECT_EQ(0u, from_hex.finish_into(decoded_output.data(), capacity));
+		EXPECT_EQ(data, decoded);
+	}
+
+	MemoryStream<uint8_t> stream(1000);
+	stream.write(data.data(), data.size());
+	ToHexTransform<uint8_t> to_hex(HexFormat::UPPERCASE);
+	EXPECT_EQ(ToHexReference(data, "0123456789ABCDEF"), stream.to_string(to_hex));
+}
+
+TEST(hex_case, transform_into_test)
+{
+	tests::ForEachSimdLevel(TransformIntoTest);
+}
+
+static void BadCharacterOffsetTest()
+{
+	auto hex = ToHexReference(LargeData(), "0123456789abcdef");
+
+	for (auto offset : { 0u, 5001u, 70000u })
+	{
+		auto data = hex;
+		data[offset] = 'g';
+
+		FromHexTransform<uint8_t> transform;
+		EXPECT_EQ(FromHexTransform<uint8_t>::NO_ERROR_OFFSET, transform.error_offset());
+		EXPECT_THROW(FromHex(transform, data, 4096), IOStreamsException);
+		EXPECT_EQ(offset, transform.error_offset());
+
+		transform.update_final(nullptr);
+		EXPECT_EQ(FromHexTransform<uint8_t>::NO_ERROR_OFFSET, transform.error_offset());
+	}
+
+	std::string data = "0a 0b\r\n0c " + std::string(1, static_cast<char>(0xC1));
+	FromHexTransform<uint8_t> transform;
+	EXPECT_THROW(FromHex(transform, data, 3), IOStreamsException);
+	EXPECT_EQ(data.size() - 1, transform.error_offset());
+}
+
+TEST(hex_case, bad_character_offset_test)
+{
+	tests::ForEachSimdLevel(BadCharacterOffsetTest);
 }
\ No newline at end of file
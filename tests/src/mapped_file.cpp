@@ -0,0 +1,147 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined (__linux__) || defined (__APPLE__)
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/mapped_file.h"
+#include <unistd.h>
+
+using namespace iostreams;
+
+using tests::CreateTempPath;
+
+MappedFileStream<uint8_t> CreateTempMappedFile()
+{
+	auto path = CreateTempPath();
+	auto stream = MappedFileStream<uint8_t>::open(path.c_str(), FileAccess::READ_WRITE, FileMode::F_OPEN_EXISTING, FileShare::NONE);
+	::unlink(path.c_str());
+	return stream;
+}
+
+TEST(mapped_file_stream_case, to_string_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::ToStringTest(stream);
+}
+
+TEST(mapped_file_stream_case, seek_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::SeekTest(stream);
+}
+
+TEST(mapped_file_stream_case, seek_out_of_range_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::SeekOutOffRangeTest(stream);
+}
+
+TEST(mapped_file_stream_case, read_write_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::ReadWriteTest(stream);
+}
+
+TEST(mapped_file_stream_case, read_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::ReadTest(stream);
+}
+
+TEST(mapped_file_stream_case, resize_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::ResizeTest(stream);
+}
+
+TEST(mapped_file_stream_case, positional_read_write_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(mapped_file_stream_case, vectored_read_write_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(mapped_file_stream_case, read_all_to_string_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::ReadAllToStringTest(stream);
+}
+
+TEST(mapped_file_stream_case, read_all_to_vector_test)
+{
+	auto stream = CreateTempMappedFile();
+	tests::ReadAllToVectorTest(stream);
+}
+
+TEST(mapped_file_stream_case, view_test)
+{
+	auto stream = CreateTempMappedFile();
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+
+	auto data = stream.view(3, 4);
+	EXPECT_EQ(std::vector<uint8_t>({ 4, 5, 6, 7 }), std::vector<uint8_t>(data, data + 4));
+	EXPECT_THROW(stream.view(10, 4), IOStreamsException);
+}
+
+TEST(mapped_file_stream_case, reopen_test)
+{
+	auto path = CreateTempPath();
+
+	{
+		auto stream = MappedFileStream<uint8_t>::open(path.c_str(), FileAccess::WRITE, FileMode::F_OPEN_EXISTING, FileShare::NONE);
+		stream.write(TEST_DATA.data(), TEST_DATA.size());
+		EXPECT_LE(TEST_DATA.size(), stream.capacity());
+	}
+
+	auto stream = MappedFileStream<uint8_t>::open(path.c_str(), FileAccess::READ, FileMode::F_OPEN_EXISTING, FileShare::NONE);
+	::unlink(path.c_str());
+
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+	EXPECT_THROW(stream.write(TEST_DATA.data(), TEST_DATA.size()), IOStreamsException);
+}
+
+TEST(mapped_file_stream_case, flush_trims_file_test)
+{
+	auto path = CreateTempPath();
+	auto stream = MappedFileStream<uint8_t>::open(path.c_str(), FileAccess::READ_WRITE, FileMode::F_OPEN_EXISTING, FileShare::NONE);
+	auto file = FileStream<uint8_t>::open(path.c_str(), FileAccess::READ, FileMode::F_OPEN_EXISTING, FileShare::NONE);
+	::unlink(path.c_str());
+
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+	EXPECT_LT(TEST_DATA.size(), file.size());
+
+	stream.flush();
+	EXPECT_EQ(TEST_DATA.size(), file.size());
+	EXPECT_EQ(TEST_DATA, file.read_all<std::vector<uint8_t>>());
+
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+	stream.flush();
+	EXPECT_EQ(2 * TEST_DATA.size(), file.size());
+	EXPECT_EQ(2 * TEST_DATA.size(), stream.size());
+
+	stream.resize(0);
+	stream.flush();
+	EXPECT_EQ(0u, file.size());
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+	stream.seek(0);
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+}
+
+#endif
\ No newline at end of file
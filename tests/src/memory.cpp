@@ -13,6 +13,7 @@
 #include "utils.h"
 #include "stream_test.h"
 #include "iostreams/memory.h"
+#include "iostreams/array.h"
 #include "liberror/exception.h"
 
 using namespace iostreams;
@@ -106,6 +107,161 @@ TEST(memory_stream_case, resize_test)
 	tests::ResizeTest(stream);
 }
 
+TEST(memory_stream_case, positional_read_write_test)
+{
+	MemoryStream<uint8_t> stream(3);
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(memory_stream_case, vectored_read_write_test)
+{
+	MemoryStream<uint8_t> stream(3);
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(memory_stream_case, write_to_test)
+{
+	MemoryStream<uint8_t> stream(3);
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+
+	ArrayStream<uint8_t> target;
+	EXPECT_EQ(TEST_DATA.size(), stream.write_to(&target));
+	target.seek(0);
+	EXPECT_EQ(TEST_DATA, target.read_all<std::vector<uint8_t>>());
+}
+
+TEST(memory_stream_case, copy_test)
+{
+	MemoryStream<uint8_t> stream(3);
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+
+	MemoryStream<uint8_t> copy(stream);
+	stream.pwrite(0, TEST_DATA.data() + 5, 1);
+	EXPECT_EQ(stream.tell(), copy.tell());
+
+	copy.seek(0);
+	EXPECT_EQ(TEST_DATA, copy.read_all<std::vector<uint8_t>>());
+}
+
+TEST(memory_stream_case, adopt_test)
+{
+	auto data = new uint8_t[TEST_DATA.size()];
+	std::memcpy(data, TEST_DATA.data(), TEST_DATA.size());
+	bool deleted{ false };
+
+	{
+		auto stream = MemoryStream<uint8_t>::adopt(data, TEST_DATA.size(), [&deleted](uint8_t* ptr) { deleted = true; delete[] ptr; });
+		EXPECT_EQ(TEST_DATA.size(), stream.size());
+		EXPECT_EQ(TEST_DATA.size(), stream.capacity());
+		EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+
+		stream.pwrite(0, TEST_DATA.data() + 12, 1);
+		EXPECT_EQ(13, data[0]);
+
+		stream.pwrite(13, TEST_DATA.data(), 2);
+		EXPECT_EQ(15u, stream.size());
+		EXPECT_FALSE(deleted);
+	}
+
+	EXPECT_TRUE(deleted);
+
+	std::vector<uint8_t> external(TEST_DATA);
+	auto stream = MemoryStream<uint8_t>::adopt(external.data(), external.size());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+}
+
+TEST(memory_stream_case, blocks_test)
+{
+	MemoryStream<uint8_t> stream(4);
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+
+	std::vector<uint8_t> result;
+
+	for (auto& block : stream.blocks())
+	{
+		result.insert(result.end(), block.data, block.data + block.size);
+	}
+
+	EXPECT_EQ(TEST_DATA, result);
+
+	auto blocks = stream.blocks(3, 6);
+	ASSERT_EQ(3u, blocks.size());
+	EXPECT_EQ(1u, blocks[0].size);
+	EXPECT_EQ(4u, blocks[1].size);
+	EXPECT_EQ(1u, blocks[2].size);
+	EXPECT_EQ(4, blocks[0].data[0]);
+	EXPECT_EQ(9, blocks[2].data[0]);
+
+	EXPECT_TRUE(stream.blocks(13, 1).empty());
+}
+
+TEST(memory_stream_case, prepare_commit_test)
+{
+	MemoryStream<uint8_t> stream(4);
+	stream.write(TEST_DATA.data(), 6);
+
+	auto buffers = stream.prepare(7);
+	ASSERT_EQ(3u, buffers.size());
+	EXPECT_EQ(2u, buffers[0].size);
+	EXPECT_EQ(6u, stream.size());
+
+	size_t offset = 6;
+
+	for (auto& buffer : buffers)
+	{
+		std::memcpy(buffer.data, TEST_DATA.data() + offset, buffer.size);
+		offset += buffer.size;
+	}
+
+	stream.commit(7);
+	EXPECT_EQ(13u, stream.size());
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+	EXPECT_THROW(stream.commit(stream.capacity() - stream.size() + 1), IOStreamsException);
+}
+
+TEST(memory_stream_case, snapshot_test)
+{
+	auto pool = BlockPool<uint8_t>::create(4);
+	MemoryStream<uint8_t> stream(4, pool);
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+
+	auto snapshot = stream.snapshot();
+	EXPECT_EQ(0u, snapshot.tell());
+	EXPECT_EQ(4u, pool->used_blocks());
+
+	stream.pwrite(5, TEST_DATA.data(), 2);
+	EXPECT_EQ(5u, pool->used_blocks());
+
+	stream.pwrite(6, TEST_DATA.data(), 1);
+	EXPECT_EQ(5u, pool->used_blocks());
+
+	snapshot.pwrite(0, TEST_DATA.data() + 12, 1);
+	EXPECT_EQ(6u, pool->used_blocks());
+
+	std::vector<uint8_t> expected(TEST_DATA);
+	expected[0] = 13;
+	EXPECT_EQ(expected, snapshot.read_all<std::vector<uint8_t>>());
+
+	expected = TEST_DATA;
+	expected[5] = 1;
+	expected[6] = 1;
+	stream.seek(0);
+	EXPECT_EQ(expected, stream.read_all<std::vector<uint8_t>>());
+}
+
+TEST(memory_stream_case, resize_after_shrink_test)
+{
+	MemoryStream<uint8_t> stream(3);
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+
+	stream.resize(4);
+	EXPECT_EQ(4u, stream.tell());
+	EXPECT_EQ(6u, stream.capacity());
+
+	stream.resize(8);
+	EXPECT_EQ(std::vector<uint8_t>({ 1, 2, 3, 4, 0, 0, 0, 0 }), stream.read_all<std::vector<uint8_t>>());
+}
+
 TEST(memory_stream_case, read_all_to_string_test)
 {
 	MemoryStream<uint8_t> stream(3);
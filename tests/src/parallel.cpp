@@ -0,0 +1,163 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "iostreams/transform/string_transform/parallel.h"
+#include "iostreams/transform/string_transform/base64.h"
+#include "iostreams/transform/string_transform/hex.h"
+#include "iostreams/error.h"
+
+using namespace iostreams;
+
+namespace
+{
+	constexpr size_t DATA_SIZE{ 1024 * 1024 + 7 };
+
+	ParallelOptions TestOptions()
+	{
+		ParallelOptions options;
+		options.threads = 4;
+		options.chunk_size = 16 * 1024;
+		return options;
+	}
+
+	std::vector<uint8_t> LargeData()
+	{
+		std::vector<uint8_t> data(DATA_SIZE);
+
+		for (size_t i = 0; i < data.size(); ++i)
+		{
+			data[i] = static_cast<uint8_t>(i * 31 + i / 509);
+		}
+
+		return data;
+	}
+
+	// the first prefix_size elements go through update to leave the transform in the middle of a block
+	template<typename transform_type, typename source_type, typename destination_type = typename transform_type::value_type>
+	std::vector<destination_type> Transform(transform_type transformer, const std::vector<source_type>& data, bool parallel, size_t prefix_size = 0)
+	{
+		std::vector<destination_type> result;
+
+		auto handler = [&result](const destination_type* data, size_t size)
+		{
+			result.insert(result.end(), data, data + size);
+		};
+
+		transformer.update(data.data(), prefix_size, handler);
+
+		if (parallel)
+		{
+			parallel_update(transformer, data.data() + prefix_size, data.size() - prefix_size, handler, TestOptions());
+		}
+		else
+		{
+			transformer.update(data.data() + prefix_size, data.size() - prefix_size, handler);
+		}
+
+		transformer.update_final(handler);
+		return result;
+	}
+
+	template<typename transform_type>
+	std::vector<char> ToString(transform_type transformer, const std::vector<uint8_t>& data, size_t prefix_size = 0)
+	{
+		return Transform<transform_type, uint8_t, char>(transformer, data, false, prefix_size);
+	}
+}
+
+TEST(parallel_case, to_base64_test)
+{
+	auto data = LargeData();
+	std::vector<Base64Options> formats(4);
+	formats[1].alphabet = Base64Alphabet::URL_SAFE;
+	formats[1].padding = false;
+	formats[2].line_length = 76;
+	formats[3].line_length = 64;
+	formats[3].line_break = LineBreak::LF;
+
+	for (const auto& options : formats)
+	{
+		for (auto prefix_size : { 0u, 1u, 100u })
+		{
+			ToBase64Transform<uint8_t> transformer(options);
+			auto expected = ToString(transformer, data, prefix_size);
+			EXPECT_EQ(expected, (Transform<ToBase64Transform<uint8_t>, uint8_t, char>(transformer, data, true, prefix_size)));
+		}
+	}
+}
+
+TEST(parallel_case, from_base64_test)
+{
+	auto data = LargeData();
+	Base64Options options;
+	options.line_length = 76;
+
+	auto plain = ToString(ToBase64Transform<uint8_t>(), data);
+	auto wrapped = ToString(ToBase64Transform<uint8_t>(options), data);
+
+	for (auto prefix_size : { 0u, 2u, 79u })
+	{
+		EXPECT_EQ(data, (Transform<FromBase64Transform<uint8_t>, char>(FromBase64Transform<uint8_t>(), plain, true, prefix_size)));
+		EXPECT_EQ(data, (Transform<FromBase64Transform<uint8_t>, char>(FromBase64Transform<uint8_t>(), wrapped, true, prefix_size)));
+	}
+
+	// lines that do not hold whole blocks
+	std::vector<char> uneven;
+
+	for (size_t i = 0; i < plain.size(); ++i)
+	{
+		uneven.push_back(plain[i]);
+
+		if (i % 10 == 9)
+		{
+			uneven.push_back('\n');
+		}
+	}
+
+	EXPECT_EQ(data, (Transform<FromBase64Transform<uint8_t>, char>(FromBase64Transform<uint8_t>(), uneven, true)));
+}
+
+TEST(parallel_case, hex_test)
+{
+	auto data = LargeData();
+	ToHexTransform<uint8_t> to_hex(HexFormat::UPPERCASE);
+	auto hex = ToString(to_hex, data);
+
+	EXPECT_EQ(hex, (Transform<ToHexTransform<uint8_t>, uint8_t, char>(to_hex, data, true)));
+	EXPECT_EQ(data, (Transform<FromHexTransform<uint8_t>, char>(FromHexTransform<uint8_t>(), hex, true, 1)));
+
+	std::vector<char> spaced;
+
+	for (size_t i = 0; i < hex.size(); i += 2)
+	{
+		spaced.push_back(hex[i]);
+		spaced.push_back(' ');
+		spaced.push_back(hex[i + 1]);
+		spaced.push_back(i % 64 == 62 ? '\n' : ' ');
+	}
+
+	EXPECT_EQ(data, (Transform<FromHexTransform<uint8_t>, char>(FromHexTransform<uint8_t>(), spaced, true)));
+}
+
+TEST(parallel_case, small_data_test)
+{
+	std::vector<uint8_t> data{ 1, 2, 3, 4, 5 };
+	EXPECT_EQ(ToString(ToBase64Transform<uint8_t>(), data), (Transform<ToBase64Transform<uint8_t>, uint8_t, char>(ToBase64Transform<uint8_t>(), data, true)));
+}
+
+TEST(parallel_case, bad_character_test)
+{
+	auto hex = ToString(ToHexTransform<uint8_t>(), LargeData());
+	hex[hex.size() / 2 + 1] = 'x';
+
+	EXPECT_THROW((Transform<FromHexTransform<uint8_t>, char>(FromHexTransform<uint8_t>(), hex, true)), IOStreamsException);
+}
\ No newline at end of file
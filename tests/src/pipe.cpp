@@ -0,0 +1,132 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "iostreams/pipe.h"
+#include "iostreams/memory.h"
+#include "iostreams/transform/string_transform/hex.h"
+#include <thread>
+
+using namespace iostreams;
+
+TEST(pipe_stream_case, create_test)
+{
+	auto pipe = PipeStream<uint8_t>::create(5);
+	EXPECT_TRUE(pipe.first.is_writer());
+	EXPECT_FALSE(pipe.second.is_writer());
+	EXPECT_EQ(8u, pipe.first.capacity());
+	EXPECT_EQ(8u, pipe.first.available());
+	EXPECT_EQ(0u, pipe.second.available());
+	EXPECT_FALSE(pipe.second.eof());
+}
+
+TEST(pipe_stream_case, non_blocking_test)
+{
+	auto pipe = PipeStream<uint8_t>::create(8);
+	auto& writer = pipe.first;
+	auto& reader = pipe.second;
+	writer.set_blocking(false);
+	reader.set_blocking(false);
+
+	EXPECT_EQ(8u, writer.write(TEST_DATA.data(), TEST_DATA.size()));
+	EXPECT_EQ(0u, writer.write(TEST_DATA.data(), 1));
+	EXPECT_EQ(8u, reader.available());
+
+	std::vector<uint8_t> buffer(TEST_DATA.size());
+	EXPECT_EQ(6u, reader.read(buffer.data(), 6));
+	EXPECT_EQ(5u, writer.write(TEST_DATA.data() + 8, 5));
+	EXPECT_EQ(7u, reader.read(buffer.data() + 6, 7));
+	EXPECT_EQ(TEST_DATA, buffer);
+
+	EXPECT_EQ(13u, writer.tell());
+	EXPECT_EQ(13u, reader.tell());
+	EXPECT_EQ(13u, reader.size());
+
+	EXPECT_EQ(0u, reader.read(buffer.data(), 1));
+	EXPECT_FALSE(reader.eof());
+	writer.close();
+	EXPECT_TRUE(reader.eof());
+}
+
+TEST(pipe_stream_case, transfer_test)
+{
+	std::vector<uint8_t> data(1024 * 1024 + 17);
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 31 + i / 256);
+	}
+
+	auto pipe = PipeStream<uint8_t>::create(4096);
+	auto writer = std::move(pipe.first);
+	auto reader = std::move(pipe.second);
+
+	std::thread producer([&writer, &data]()
+	{
+		for (auto& chunk : tests::SplitData(data, 1000))
+		{
+			writer.write(chunk.data(), chunk.size());
+		}
+
+		writer.close();
+	});
+
+	std::vector<uint8_t> result;
+	std::vector<uint8_t> buffer(777);
+	size_t read_bytes{ 0 };
+
+	while ((read_bytes = reader.read(buffer.data(), buffer.size())) > 0)
+	{
+		result.insert(result.end(), buffer.begin(), buffer.begin() + read_bytes);
+	}
+
+	producer.join();
+	EXPECT_TRUE(reader.eof());
+	EXPECT_EQ(data, result);
+}
+
+TEST(pipe_stream_case, transform_test)
+{
+	auto pipe = PipeStream<uint8_t>::create(4);
+	auto writer = std::move(pipe.first);
+	auto reader = std::move(pipe.second);
+
+	std::thread producer([&writer]()
+	{
+		writer.write(TEST_DATA.data(), TEST_DATA.size());
+		writer.close();
+	});
+
+	ToHexTransform<uint8_t> transformer;
+	EXPECT_EQ("0102030405060708090a0b0c0d", reader.to_string(transformer));
+	producer.join();
+}
+
+TEST(pipe_stream_case, broken_pipe_test)
+{
+	auto pipe = PipeStream<uint8_t>::create(4);
+	pipe.second.close();
+	EXPECT_THROW(pipe.first.write(TEST_DATA.data(), TEST_DATA.size()), IOStreamsException);
+	uint8_t byte{ 0 };
+	EXPECT_THROW(pipe.second.read(&byte, 1), IOStreamsException);
+}
+
+TEST(pipe_stream_case, unsupported_operations_test)
+{
+	auto pipe = PipeStream<uint8_t>::create(4);
+	uint8_t byte{ 0 };
+	EXPECT_THROW(pipe.first.read(&byte, 1), IOStreamsException);
+	EXPECT_THROW(pipe.second.write(&byte, 1), IOStreamsException);
+	EXPECT_THROW(pipe.first.seek(0), IOStreamsException);
+	EXPECT_THROW(pipe.second.resize(0), IOStreamsException);
+	EXPECT_THROW(pipe.second.pread(0, &byte, 1), IOStreamsException);
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/ring.h"
+#include <thread>
+
+using namespace iostreams;
+
+TEST(ring_stream_case, to_string_test)
+{
+	RingStream<uint8_t> stream(4096);
+	tests::ToStringTest(stream);
+}
+
+TEST(ring_stream_case, seek_out_of_range_test)
+{
+	RingStream<uint8_t> stream(4096);
+	tests::SeekOutOffRangeTest(stream);
+}
+
+TEST(ring_stream_case, resize_test)
+{
+	RingStream<uint8_t> stream(4096);
+	tests::ResizeTest(stream);
+}
+
+TEST(ring_stream_case, positional_read_write_test)
+{
+	RingStream<uint8_t> stream(4096);
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(ring_stream_case, read_all_to_vector_test)
+{
+	RingStream<uint8_t> stream(4096);
+	tests::ReadAllToVectorTest(stream);
+}
+
+TEST(ring_stream_case, read_write_test)
+{
+	RingStream<uint8_t> stream(1);
+	EXPECT_EQ(0u, stream.capacity() % 4096);
+	EXPECT_EQ(TEST_DATA.size(), stream.write(TEST_DATA.data(), TEST_DATA.size()));
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+	EXPECT_EQ(0u, stream.tell());
+
+	std::vector<uint8_t> buffer(TEST_DATA.size());
+	EXPECT_EQ(5u, stream.read(buffer.data(), 5));
+	EXPECT_EQ(8u, stream.read(buffer.data() + 5, 20));
+	EXPECT_EQ(TEST_DATA, buffer);
+	EXPECT_EQ(0u, stream.read(buffer.data(), 1));
+}
+
+TEST(ring_stream_case, overwrite_test)
+{
+	RingStream<uint8_t> stream(4096);
+	auto capacity = stream.capacity();
+	std::vector<uint8_t> data(capacity + 100);
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 7);
+	}
+
+	stream.write(data.data(), 50);
+	stream.write(data.data() + 50, data.size() - 50);
+	EXPECT_EQ(data.size(), stream.size());
+	EXPECT_EQ(100u, stream.window_begin());
+	EXPECT_EQ(capacity, stream.window_size());
+	EXPECT_EQ(100u, stream.tell());
+	EXPECT_THROW(stream.seek(99), IOStreamsException);
+
+	auto view = stream.view();
+	ASSERT_EQ(capacity, view.size);
+	EXPECT_EQ(std::vector<uint8_t>(data.begin() + 100, data.end()), std::vector<uint8_t>(view.data, view.data + view.size));
+
+	std::vector<uint8_t> tail(data.end() - 300, data.end());
+	stream.write(tail.data(), tail.size());
+	view = stream.view(stream.size() - 300, 1000);
+	ASSERT_EQ(300u, view.size);
+	EXPECT_EQ(tail, std::vector<uint8_t>(view.data, view.data + view.size));
+
+	std::vector<uint8_t> big(3 * capacity, 5);
+	big.back() = 6;
+	stream.write(big.data(), big.size());
+	EXPECT_EQ(capacity, stream.window_size());
+	EXPECT_EQ(6, stream.view(stream.size() - 1, 1).data[0]);
+}
+
+TEST(ring_stream_case, consume_test)
+{
+	RingStream<uint8_t> stream(4096, RingOverflow::BLOCK);
+	stream.write(TEST_DATA.data(), TEST_DATA.size());
+	stream.consume(4);
+	EXPECT_EQ(4u, stream.window_begin());
+	EXPECT_EQ(4u, stream.tell());
+
+	auto view = stream.view();
+	EXPECT_EQ(std::vector<uint8_t>(TEST_DATA.begin() + 4, TEST_DATA.end()), std::vector<uint8_t>(view.data, view.data + view.size));
+	EXPECT_THROW(stream.consume(10), IOStreamsException);
+
+	uint8_t byte{ 0 };
+	EXPECT_THROW(stream.pread(3, &byte, 1), IOStreamsException);
+}
+
+TEST(ring_stream_case, block_test)
+{
+	RingStream<uint8_t> stream(4096, RingOverflow::BLOCK);
+	auto capacity = stream.capacity();
+	std::vector<uint8_t> data(capacity * 4 + 123);
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<uint8_t>(i * 13 + i / 251);
+	}
+
+	std::thread producer([&stream, &data]()
+	{
+		stream.write(data.data(), data.size());
+	});
+
+	std::vector<uint8_t> result;
+
+	while (result.size() < data.size())
+	{
+		auto view = stream.view();
+		result.insert(result.end(), view.data, view.data + view.size);
+		stream.consume(view.size);
+		EXPECT_LE(stream.window_size(), capacity);
+	}
+
+	producer.join();
+	EXPECT_EQ(data, result);
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/slice.h"
+#include "iostreams/array.h"
+
+using namespace iostreams;
+
+namespace
+{
+	SliceStream<uint8_t> CreateSliceStream()
+	{
+		auto parent = std::make_shared<ArrayStream<uint8_t>>(std::vector<uint8_t>(30, 0xFF));
+		return SliceStream<uint8_t>(parent, 5, TEST_DATA.size());
+	}
+}
+
+TEST(slice_stream_case, to_string_test)
+{
+	auto stream = CreateSliceStream();
+	tests::ToStringTest(stream);
+}
+
+TEST(slice_stream_case, seek_test)
+{
+	auto stream = CreateSliceStream();
+	tests::SeekTest(stream);
+}
+
+TEST(slice_stream_case, seek_out_of_range_test)
+{
+	auto stream = CreateSliceStream();
+	tests::SeekOutOffRangeTest(stream);
+}
+
+TEST(slice_stream_case, read_write_test)
+{
+	auto stream = CreateSliceStream();
+	tests::ReadWriteTest(stream);
+
+	std::vector<uint8_t> expected(30, 0xFF);
+	std::copy(TEST_DATA.begin(), TEST_DATA.end(), expected.begin() + 5);
+	EXPECT_EQ(expected, stream.stream()->read_all<std::vector<uint8_t>>());
+}
+
+TEST(slice_stream_case, read_test)
+{
+	auto stream = CreateSliceStream();
+	tests::ReadTest(stream);
+}
+
+TEST(slice_stream_case, vectored_read_write_test)
+{
+	auto stream = CreateSliceStream();
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(slice_stream_case, bounds_test)
+{
+	auto parent = std::make_shared<ArrayStream<uint8_t>>(std::vector<uint8_t>(TEST_DATA));
+	SliceStream<uint8_t> stream(parent, 4, 6);
+	parent->seek(2);
+
+	std::vector<uint8_t> buffer(10);
+	EXPECT_EQ(6u, stream.read(buffer.data(), buffer.size()));
+	EXPECT_EQ(std::vector<uint8_t>({ 5, 6, 7, 8, 9, 10 }), std::vector<uint8_t>(buffer.begin(), buffer.begin() + 6));
+	EXPECT_EQ(0u, stream.read(buffer.data(), buffer.size()));
+	EXPECT_EQ(2u, parent->tell());
+
+	EXPECT_EQ(2u, stream.pwrite(4, TEST_DATA.data(), 5));
+	EXPECT_EQ(1, parent->read_all<std::vector<uint8_t>>()[8]);
+	EXPECT_EQ(11, parent->read_all<std::vector<uint8_t>>()[10]);
+
+	auto inner = stream.slice(1, 2);
+	EXPECT_EQ(5u, inner.offset());
+	EXPECT_EQ(2u, inner.pread(0, buffer.data(), 10));
+	EXPECT_EQ(6, buffer[0]);
+	EXPECT_THROW(stream.slice(5, 2), IOStreamsException);
+
+	EXPECT_THROW(stream.resize(7), IOStreamsException);
+	stream.seek(0, std::ios_base::end);
+	stream.resize(3);
+	EXPECT_EQ(3u, stream.size());
+	EXPECT_EQ(3u, stream.tell());
+	EXPECT_EQ(TEST_DATA.size(), parent->size());
+}
+
+TEST(slice_stream_case, past_end_test)
+{
+	auto parent = std::make_shared<ArrayStream<uint8_t>>(std::vector<uint8_t>(TEST_DATA));
+	SliceStream<uint8_t> stream(parent, 10, 100);
+	EXPECT_EQ(3u, stream.size());
+
+	std::vector<uint8_t> buffer(10);
+	EXPECT_EQ(3u, stream.read(buffer.data(), buffer.size()));
+	EXPECT_EQ(std::vector<uint8_t>({ 11, 12, 13 }), std::vector<uint8_t>(buffer.begin(), buffer.begin() + 3));
+
+	stream.seek(0, std::ios_base::end);
+	EXPECT_EQ(3u, stream.tell());
+
+	SliceStream<uint8_t> empty(parent, 20, 5);
+	EXPECT_EQ(0u, empty.size());
+	EXPECT_EQ(0u, empty.pread(0, buffer.data(), buffer.size()));
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>
+// Author: Andrew Stalin <andrew.stalin@gmail.com>
+//
+// THE SOFTWARE  IS PROVIDED "AS  IS", WITHOUT WARRANTY  OF ANY KIND,  EXPRESS OR
+// IMPLIED,  INCLUDING BUT  NOT  LIMITED TO  THE  WARRANTIES OF  MERCHANTABILITY,
+// FITNESS FOR  A PARTICULAR PURPOSE AND  NONINFRINGEMENT. IN NO EVENT  SHALL THE
+// AUTHORS  OR COPYRIGHT  HOLDERS  BE  LIABLE FOR  ANY  CLAIM,  DAMAGES OR  OTHER
+// LIABILITY, WHETHER IN AN ACTION OF  CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE  OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tests.h"
+#include "utils.h"
+#include "stream_test.h"
+#include "iostreams/spill.h"
+
+using namespace iostreams;
+
+TEST(spill_stream_case, to_string_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::ToStringTest(stream);
+	EXPECT_TRUE(stream.spilled());
+}
+
+TEST(spill_stream_case, seek_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::SeekTest(stream);
+}
+
+TEST(spill_stream_case, seek_out_of_range_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::SeekOutOffRangeTest(stream);
+}
+
+TEST(spill_stream_case, read_write_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::ReadWriteTest(stream);
+}
+
+TEST(spill_stream_case, read_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::ReadTest(stream);
+}
+
+TEST(spill_stream_case, resize_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::ResizeTest(stream);
+}
+
+TEST(spill_stream_case, positional_read_write_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::PositionalReadWriteTest(stream);
+}
+
+TEST(spill_stream_case, vectored_read_write_test)
+{
+	SpillStream<uint8_t> stream(4);
+	tests::VectoredReadWriteTest(stream);
+}
+
+TEST(spill_stream_case, in_memory_test)
+{
+	SpillStream<uint8_t> stream;
+	tests::ReadWriteTest(stream);
+	EXPECT_FALSE(stream.spilled());
+}
+
+TEST(spill_stream_case, spill_test)
+{
+	SpillStream<uint8_t> stream(8);
+	stream.write(TEST_DATA.data(), 8);
+	stream.seek(3);
+	EXPECT_FALSE(stream.spilled());
+
+	stream.pwrite(8, TEST_DATA.data() + 8, 5);
+	EXPECT_TRUE(stream.spilled());
+	EXPECT_EQ(3u, stream.tell());
+	EXPECT_EQ(TEST_DATA.size(), stream.size());
+
+	stream.seek(0);
+	EXPECT_EQ(TEST_DATA, stream.read_all<std::vector<uint8_t>>());
+}
+
+TEST(spill_stream_case, resize_spill_test)
+{
+	SpillStream<uint8_t> stream(8);
+	stream.write(TEST_DATA.data(), 4);
+	stream.resize(16);
+	EXPECT_TRUE(stream.spilled());
+	EXPECT_EQ(16u, stream.size());
+
+	std::vector<uint8_t> expected(TEST_DATA.begin(), TEST_DATA.begin() + 4);
+	expected.resize(16);
+	stream.seek(0);
+	EXPECT_EQ(expected, stream.read_all<std::vector<uint8_t>>());
+}
\ No newline at end of file
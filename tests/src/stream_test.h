@@ -131,6 +131,58 @@ namespace iostreams
 			EXPECT_EQ(5u, stream.tell());
 		}
 
+		template<typename byte_type>
+		void PositionalReadWriteTest(iostreams::IStream<byte_type>& stream)
+		{
+			stream.write(TEST_DATA.data(), TEST_DATA.size());
+			stream.seek(3);
+
+			std::vector<uint8_t> buffer(TEST_DATA.size());
+			auto read_bytes = stream.pread(5, buffer.data(), 4);
+			EXPECT_EQ(std::vector<uint8_t>({ 6, 7, 8, 9 }), std::vector<uint8_t>(buffer.data(), buffer.data() + read_bytes));
+			EXPECT_EQ(3u, stream.tell());
+
+			read_bytes = stream.pread(11, buffer.data(), 10);
+			EXPECT_EQ(std::vector<uint8_t>({ 12, 13 }), std::vector<uint8_t>(buffer.data(), buffer.data() + read_bytes));
+			EXPECT_EQ(0u, stream.pread(20, buffer.data(), 10));
+
+			EXPECT_EQ(2u, stream.pwrite(1, TEST_DATA.data() + 10, 2));
+			EXPECT_EQ(2u, stream.pwrite(15, TEST_DATA.data(), 2));
+			EXPECT_EQ(3u, stream.tell());
+			EXPECT_EQ(17u, stream.size());
+
+			std::vector<uint8_t> expected(TEST_DATA);
+			expected[1] = 11;
+			expected[2] = 12;
+			expected.insert(expected.end(), { 0, 0, 1, 2 });
+
+			buffer.resize(expected.size());
+			read_bytes = stream.pread(0, buffer.data(), buffer.size());
+			EXPECT_EQ(expected.size(), read_bytes);
+			EXPECT_EQ(expected, buffer);
+		}
+
+		template<typename byte_type>
+		void VectoredReadWriteTest(iostreams::IStream<byte_type>& stream)
+		{
+			using ConstBuffer = typename iostreams::IStream<byte_type>::ConstBuffer;
+			using Buffer = typename iostreams::IStream<byte_type>::Buffer;
+
+			std::vector<ConstBuffer> source = { { TEST_DATA.data(), 3 }, { TEST_DATA.data(), 0 }, { TEST_DATA.data() + 3, 10 } };
+			EXPECT_EQ(TEST_DATA.size(), stream.writev(source.data(), source.size()));
+			EXPECT_EQ(TEST_DATA.size(), stream.tell());
+			EXPECT_EQ(TEST_DATA.size(), stream.size());
+
+			stream.seek(2);
+			std::vector<uint8_t> head(4);
+			std::vector<uint8_t> tail(10);
+			std::vector<Buffer> target = { { head.data(), head.size() }, { tail.data(), tail.size() } };
+			EXPECT_EQ(11u, stream.readv(target.data(), target.size()));
+			EXPECT_EQ(TEST_DATA.size(), stream.tell());
+			EXPECT_EQ(std::vector<uint8_t>({ 3, 4, 5, 6 }), head);
+			EXPECT_EQ(std::vector<uint8_t>({ 7, 8, 9, 10, 11, 12, 13 }), std::vector<uint8_t>(tail.begin(), tail.begin() + 7));
+		}
+
 		template<typename byte_type>
 		void ReadAllToVectorTest(iostreams::IStream<byte_type>& stream)
 		{
@@ -15,11 +15,34 @@
 #include "tests.h"
 #include "utils.h"
 #include "iostreams/transform/transform.h"
+#include "simd.h"
 
 namespace iostreams
 {
 	namespace tests
 	{
+		// runs test with the vector kernels capped at every level up to the detected one
+		template<typename test_type>
+		void ForEachSimdLevel(test_type test)
+		{
+			struct LevelGuard
+			{
+				~LevelGuard() { simd::reset_level(); }
+			} guard;
+
+			for (auto level : { simd::Level::NONE, simd::Level::SSSE3, simd::Level::AVX2, simd::Level::AVX512 })
+			{
+				if (level > simd::detect_level())
+				{
+					break;
+				}
+
+				SCOPED_TRACE("simd level " + std::to_string(static_cast<int>(level)));
+				simd::set_level(level);
+				test();
+			}
+		}
+
 		template<typename transformer_type, typename data_type = typename transformer_type::value_type>
 		void FromStringTransformTest(const std::string& data, const std::vector<data_type>& expected)
 		{
@@ -10,10 +10,13 @@
 // SOFTWARE.
 
 #include "utils.h"
+#include <cstdlib>
 #include <random>
 
 #ifdef _WIN32
 #include <Windows.h>
+#elif defined (__linux__) || defined (__APPLE__)
+#include <unistd.h>
 #endif
 
 namespace iostreams
@@ -28,6 +31,37 @@ namespace iostreams
 			return static_cast<size_t>(dis(gen));
 		}
 
+		FileStream<uint8_t> CreateTempFile()
+		{
+#ifdef _WIN32
+			char buffer[L_tmpnam_s];
+			tmpnam_s(buffer, L_tmpnam_s);
+			return FileStream<uint8_t>::open(buffer, FileAccess::READ_WRITE, FileMode::F_CREATE_NEW, FileShare::SHARE_DELETE, FILE_FLAG_DELETE_ON_CLOSE);
+#elif defined(__APPLE__) & defined(__MACH__)
+			return FileStream<uint8_t>::create(::tmpfile());
+#elif defined(__linux__)
+			return FileStream<uint8_t>::create(::tmpfile64());
+#endif
+		}
+
+		std::string CreateTempPath()
+		{
+#ifdef _WIN32
+			char directory[MAX_PATH + 1];
+			char path[MAX_PATH + 1];
+			EXPECT_NE(0u, ::GetTempPathA(sizeof(directory), directory));
+			EXPECT_NE(0u, ::GetTempFileNameA(directory, "ios", 0, path));
+			return path;
+#else
+			auto directory = std::getenv("TMPDIR");
+			auto path = std::string(directory != nullptr && *directory != '\0' ? directory : "/tmp") + "/iostreams_XXXXXX";
+			auto fd = ::mkstemp(&path[0]);
+			EXPECT_NE(-1, fd);
+			::close(fd);
+			return path;
+#endif
+		}
+
 		template<typename byte_type>
 		void write_to_log(const std::vector<byte_type>& bytes)
 		{
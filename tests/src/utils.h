@@ -13,6 +13,8 @@
 #define _IOSTREAMS_TESTS_UTILS_H_
 
 #include "tests.h"
+#include "iostreams/file.h"
+#include <string>
 
 namespace iostreams
 {
@@ -20,6 +22,12 @@ namespace iostreams
 	{
 		size_t GenerateRandomNumber(size_t min_val, size_t max_val);
 
+		// anonymous read-write file that is removed once closed
+		FileStream<uint8_t> CreateTempFile();
+
+		// creates an empty file in the system temporary directory, the caller removes it
+		std::string CreateTempPath();
+
 		template<typename byte_type>
 		void write_to_log(const std::vector<byte_type>& bytes);
 